@@ -0,0 +1,214 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <ctype.h>
+
+#include "BoardFile.h"
+#include "PackedBoard.h"
+
+//Converts text boards to binary boards and back
+//Usage is BoardConverter inputFile outputFile. Text input is written out as a binary board, binary input as a text board, rule and all
+//Boards are converted a row at a time, so they never have to fit in memory
+
+/* Skips blank space up to the next non-blank character, keeping count of lines */
+int skipBlankSpace(FILE *input, long *line, long *lineStart, long *position)
+{
+    int c;
+
+    while((c = getc(input)) != EOF && isspace(c))
+    {
+        (*position)++;
+
+        if(c == '\n')
+        {
+            (*line)++;
+            *lineStart = *position;
+        }
+    }
+
+    return c;
+}
+
+/* Writes a text board as a binary board. Each row is read in one go and checked 16 cells at a time */
+void textToBinary(FILE *input, FILE *output)
+{
+    struct boardFileHeader header;
+    int generations;
+    int columns;
+    int rows;
+    char *text;
+    char *cells;
+    uint64_t *row;
+    int c;
+    int length;
+    int bad;
+    long line;
+    long lineStart;
+    long position;
+    char rule[sizeof(header.rule)];
+
+    //Reads in the generations, columns, and rows
+    if(fscanf(input, "%d %d %d ", &generations, &columns, &rows) != 3 || columns < 1 || rows < 1)
+    {
+        printf("Your file specification's jacked up, expected the number of generations, columns and rows to start the file\n");
+        exit(1);
+    }
+
+    //A line after the header that isn't a row of cells is the rule the board is for
+    strcpy(rule, BOARD_FILE_RULE);
+    c = getc(input);
+
+    if(c != EOF)
+        ungetc(c, input);
+
+    if(c != EOF && c != '*' && c != '.' && (fscanf(input, "%31s", rule) != 1 || !isspace(c = getc(input))))
+    {
+        printf("Your file specification's jacked up, expected a rule of up to %d characters or the first row after the header\n", (int)sizeof(rule) - 1);
+        exit(1);
+    }
+
+    //Counts the lines of the header so errors can say where they are
+    position = ftell(input);
+    line = 1;
+    lineStart = 0;
+    rewind(input);
+
+    for(long i = 0; i < position; i++)
+        if(getc(input) == '\n')
+        {
+            line++;
+            lineStart = i + 1;
+        }
+
+    initBoardFileHeader(&header, generations, columns, rows);
+    strcpy(header.rule, rule);
+    fwrite(&header, sizeof(header), 1, output);
+
+    text = malloc(sizeof(char) * columns);
+    cells = malloc(sizeof(char) * columns);
+    row = calloc(header.rowBytes, 1);
+
+    for(int y = 0; y < rows; y++)
+    {
+        //Rows start after blank space, which is the line ending for every row but the first
+        c = skipBlankSpace(input, &line, &lineStart, &position);
+
+        if(c != EOF)
+            ungetc(c, input);
+
+        length = fread(text, 1, columns, input);
+        bad = parseTextCells(text, length, cells);
+
+        if(bad < 0 && length < columns)
+            bad = length;
+
+        if(bad >= 0)
+        {
+            printTextBoardError(line, position - lineStart + bad + 1, columns, bad < length ? text[bad] : EOF);
+            exit(1);
+        }
+
+        position += columns;
+
+        //Something other than blank space right after the row means it's too long
+        c = getc(input);
+
+        if(c != EOF && !isspace(c))
+        {
+            printTextBoardError(line, position - lineStart + 1, columns, c);
+            exit(1);
+        }
+
+        if(c != EOF)
+            ungetc(c, input);
+
+        packRow(cells, columns, row);
+        fwrite(row, header.rowBytes, 1, output);
+    }
+
+    free(text);
+    free(cells);
+    free(row);
+}
+
+/* Writes a binary board out as a text board */
+void binaryToText(const char *inputName, FILE *output)
+{
+    struct boardFile board;
+    char *cells;
+
+    if(!mapBoardFile(inputName, &board))
+    {
+        printf("Your file specification's jacked up, might want to check it out.\n");
+        exit(1);
+    }
+
+    fprintf(output, "%u\n%u\n%u\n", board.header.generations, board.header.columns, board.header.rows);
+
+    //Boards for B3/S23 don't need to say so
+    if(strcmp(board.header.rule, BOARD_FILE_RULE) != 0)
+        fprintf(output, "%s\n", board.header.rule);
+
+    cells = malloc(sizeof(char) * board.header.columns);
+
+    for(uint32_t y = 0; y < board.header.rows; y++)
+    {
+        readBoardCells(&board, 0, y, board.header.columns, 1, cells, board.header.columns);
+
+        for(uint32_t x = 0; x < board.header.columns; x++)
+            cells[x] = cells[x] ? '*' : '.';
+
+        fwrite(cells, 1, board.header.columns, output);
+        fputc('\n', output);
+    }
+
+    free(cells);
+    unmapBoardFile(&board);
+}
+
+int main(int argc, char ** argv)
+{
+    FILE *input;
+    FILE *output;
+    char start[sizeof(BOARD_FILE_MAGIC)];
+    int length;
+
+    if(argc != 3)
+    {
+        printf("Usage: %s inputBoard outputBoard\n", argv[0]);
+        return 1;
+    }
+
+    input = fopen(argv[1], "rb");
+
+    //Breaks if the user pointed to a file that doesn't exist
+    if(input == NULL)
+    {
+        printf("Could not find file! Please restart and retry.\n");
+        return 1;
+    }
+
+    output = fopen(argv[2], "wb");
+
+    if(output == NULL)
+    {
+        printf("Could not create %s\n", argv[2]);
+        return 1;
+    }
+
+    length = fread(start, 1, sizeof(start) - 1, input);
+
+    if(isBinaryBoard(start, length))
+        binaryToText(argv[1], output);
+    else
+    {
+        rewind(input);
+        textToBinary(input, output);
+    }
+
+    fclose(input);
+    fclose(output);
+
+    return 0;
+}
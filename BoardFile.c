@@ -0,0 +1,224 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "BoardFile.h"
+#include "PackedBoard.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <ctype.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+//Board files. Most of this is the binary format, plus the pieces of reading text boards that the loader and the converter share
+//After the header each row is stored bit-packed exactly like a row of the packed engine's board: bit i of word w holds the
+//cell at x = 64w + i. Rows are a fixed rowBytes apart, so any rectangle of the board can be found without reading the rest
+
+/* Checks whether a file starts like a binary board */
+bool isBinaryBoard(const char *start, int length)
+{
+    return length >= (int)sizeof(BOARD_FILE_MAGIC) - 1 && memcmp(start, BOARD_FILE_MAGIC, sizeof(BOARD_FILE_MAGIC) - 1) == 0;
+}
+
+/* Checks whether a binary board or checkpoint was written on a machine of the other byte order, going by its version number
+   reading back byte-swapped. Those have to be converted there rather than read here */
+bool isByteSwapped(const char *start, int length)
+{
+    uint32_t version;
+
+    if(length < (int)(sizeof(((struct boardFileHeader *)0)->magic) + sizeof(version)))
+        return false;
+
+    memcpy(&version, start + sizeof(((struct boardFileHeader *)0)->magic), sizeof(version));
+
+    if(isBinaryBoard(start, length))
+        return version == __builtin_bswap32(BOARD_FILE_VERSION);
+
+    return memcmp(start, CHECKPOINT_FILE_MAGIC, sizeof(CHECKPOINT_FILE_MAGIC) - 1) == 0 && version == __builtin_bswap32(CHECKPOINT_FILE_VERSION);
+}
+
+/* Copies the header out of the start of a binary board and checks that it's one this version can read */
+bool readBoardFileHeader(const char *start, int length, struct boardFileHeader *header)
+{
+    if(!isBinaryBoard(start, length) || length < (int)sizeof(struct boardFileHeader))
+        return false;
+
+    memcpy(header, start, sizeof(struct boardFileHeader));
+    header->rule[sizeof(header->rule) - 1] = '\0';
+
+    if(header->version != BOARD_FILE_VERSION || header->columns == 0 || header->rows == 0)
+        return false;
+
+    //Rows have to be whole words long, and start on word boundaries
+    if(header->headerSize < sizeof(struct boardFileHeader) || header->headerSize % sizeof(uint64_t) != 0)
+        return false;
+
+    return header->rowBytes % sizeof(uint64_t) == 0 && header->rowBytes >= packedRowWords(header->columns) * sizeof(uint64_t);
+}
+
+/* Fills in the header for a board of some size, with rows packed as tightly as the format allows */
+void initBoardFileHeader(struct boardFileHeader *header, int generations, int columns, int rows)
+{
+    memset(header, 0, sizeof(struct boardFileHeader));
+    memcpy(header->magic, BOARD_FILE_MAGIC, sizeof(header->magic));
+    header->version = BOARD_FILE_VERSION;
+    header->headerSize = sizeof(struct boardFileHeader);
+    header->generations = generations;
+    header->columns = columns;
+    header->rows = rows;
+    header->rowBytes = packedRowWords(columns) * sizeof(uint64_t);
+    strcpy(header->rule, BOARD_FILE_RULE);
+}
+
+/* Maps a binary board file into memory. Only the pages that are actually read get loaded, so each rank only pulls in the rows
+   it needs. Returns false if the file can't be mapped or isn't a complete board */
+bool mapBoardFile(const char *fileName, struct boardFile *board)
+{
+    int fd;
+    struct stat fileStat;
+    void *data;
+
+    fd = open(fileName, O_RDONLY);
+
+    if(fd < 0)
+        return false;
+
+    if(fstat(fd, &fileStat) != 0 || fileStat.st_size < (off_t)sizeof(struct boardFileHeader))
+    {
+        close(fd);
+        return false;
+    }
+
+    data = mmap(NULL, fileStat.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);//The mapping stays valid after the file is closed
+
+    if(data == MAP_FAILED)
+        return false;
+
+    board->data = data;
+    board->size = fileStat.st_size;
+
+    if(!readBoardFileHeader(data, (int)(board->size < 4096 ? board->size : 4096), &board->header)
+       || board->size < board->header.headerSize + (size_t)board->header.rows * board->header.rowBytes)
+    {
+        unmapBoardFile(board);
+        return false;
+    }
+
+    return true;
+}
+
+/* Expands the rectangle starting at x, y into one char per cell, with rows cellsWidth chars apart in cells */
+void readBoardCells(const struct boardFile *board, int x, int y, int width, int height, char *cells, int cellsWidth)
+{
+    for(int k = 0; k < height; k++)
+    {
+        const uint64_t *row = (const uint64_t *)(board->data + board->header.headerSize + (size_t)(y + k) * board->header.rowBytes);
+
+        for(int j = 0; j < width; j++)
+            cells[(long)k * cellsWidth + j] = getPackedCell(row, 0, x + j, 0);
+    }
+}
+
+void unmapBoardFile(struct boardFile *board)
+{
+    munmap((void *)board->data, board->size);
+    board->data = NULL;
+    board->size = 0;
+}
+
+/* Copies the header out of the start of a checkpoint and checks that it's complete and one this version can read */
+bool readCheckpointHeader(const char *start, int length, struct checkpointHeader *header)
+{
+    if(length < (int)sizeof(struct checkpointHeader) || memcmp(start, CHECKPOINT_FILE_MAGIC, sizeof(header->magic)) != 0)
+        return false;
+
+    memcpy(header, start, sizeof(struct checkpointHeader));
+    header->rule[sizeof(header->rule) - 1] = '\0';
+
+    return header->version == CHECKPOINT_FILE_VERSION && header->columns > 0 && header->rows > 0 && header->blocks > 0;
+}
+
+/* Turns a run of text cells into one char per cell, 1 for a "*" and 0 for a ".". Returns the offset of the first character that
+   isn't a cell, or -1 if they all are. Every x86-64 CPU has SSE2, so 16 characters are checked at a time without any dispatch */
+int parseTextCells(const char *text, int length, char *cells)
+{
+    int i;
+
+    i = 0;
+
+#ifdef __SSE2__
+    const __m128i star = _mm_set1_epi8('*');
+    const __m128i dot = _mm_set1_epi8('.');
+    const __m128i one = _mm_set1_epi8(1);
+
+    for(; i + 16 <= length; i += 16)
+    {
+        __m128i chars = _mm_loadu_si128((const __m128i *)(text + i));
+        __m128i isStar = _mm_cmpeq_epi8(chars, star);
+        int notCells = ~_mm_movemask_epi8(_mm_or_si128(isStar, _mm_cmpeq_epi8(chars, dot))) & 0xFFFF;
+
+        if(notCells)
+            return i + __builtin_ctz(notCells);
+
+        _mm_storeu_si128((__m128i *)(cells + i), _mm_and_si128(isStar, one));
+    }
+#endif
+
+    for(; i < length; i++)
+    {
+        if(text[i] == '*')
+            cells[i] = 1;
+        else if(text[i] == '.')
+            cells[i] = 0;
+        else
+            return i;
+    }
+
+    return -1;
+}
+
+/* SplitMix64 hash of a seed and the index of a cell (y * columns + x) */
+uint64_t hashCell(uint64_t seed, uint64_t index)
+{
+    uint64_t z;
+
+    z = seed + (index + 1) * 0x9E3779B97F4A7C15ULL;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+
+    return z ^ (z >> 31);
+}
+
+/* Whether the cell with some index of a random board is alive. Each cell comes from a hash of the seed and its index rather than
+   from a running generator, so any part of a random board can be made on its own and always comes out the same */
+bool randomCell(uint64_t seed, uint64_t index, double density)
+{
+    //The top 53 bits as a fraction in [0, 1)
+    return (hashCell(seed, index) >> 11) * (1.0 / 9007199254740992.0) < density;
+}
+
+/* Explains what's wrong with the character found at some line and column of a text board whose rows should be columns cells long.
+   EOF stands for running off the end of the file */
+void printTextBoardError(long line, long column, int columns, int found)
+{
+    printf("Your file specification's jacked up at line %ld, column %ld: ", line, column);
+
+    if(found == EOF)
+        printf("the file ends partway through the board\n");
+    else if(column > columns && (found == '*' || found == '.'))
+        printf("the row is longer than %d cells\n", columns);
+    else if(column > columns)
+        printf("every row has to end the same way as the first one\n");
+    else if(found == '\n' || found == '\r')
+        printf("the row ends after %ld cells, expected %d\n", column - 1, columns);
+    else if(isprint(found))
+        printf("expected '*' or '.' but found '%c'\n", found);
+    else
+        printf("expected '*' or '.' but found byte 0x%02x\n", found & 0xFF);
+}
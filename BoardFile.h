@@ -0,0 +1,90 @@
+#ifndef BOARDFILE_H_INCLUDED
+#define BOARDFILE_H_INCLUDED
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+//Binary board files start with these 8 bytes, which can never begin a text board
+#define BOARD_FILE_MAGIC "GOLBOARD"
+#define BOARD_FILE_VERSION 1
+
+//Rule boards are for unless they say otherwise (see Rule.h for the others)
+#define BOARD_FILE_RULE "B3/S23"
+
+//Header at the start of a binary board file. Every field, and every word of the rows, is stored in the byte order of the machine
+//that wrote it, so the rows can be read as 64 bit words straight out of a mapped file. The header is padded to a whole number of words
+//for the same reason. Files only move between machines of the same byte order (all the x86 and ARM ones are little-endian), and one
+//from a machine of the other order is recognised by its version reading byte-swapped (see isByteSwapped())
+struct boardFileHeader
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t headerSize;    //Bytes from the start of the file to the first row
+    uint32_t generations;
+    uint32_t columns;
+    uint32_t rows;
+    uint32_t rowBytes;      //Bytes from the start of one row to the next
+    char rule[32];          //Birth/survival rule the board is meant for, NUL padded
+};
+
+//Checkpoints start with these 8 bytes once they've been completely written
+#define CHECKPOINT_FILE_MAGIC "GOLCHKPT"
+#define CHECKPOINT_FILE_VERSION 1
+
+//Header at the start of a checkpoint. Like board files it's in the byte order of the machine that wrote it. It's followed by a table with a block for each partition, then each partition's cells as a
+//bit stream, row after row, packed like packRegion() does it. The blocks can be read back into any other layout of partitions
+struct checkpointHeader
+{
+    char magic[8];          //All zero until the checkpoint is complete
+    uint32_t version;
+    uint32_t blocks;
+    uint32_t generation;    //Generations run so far
+    uint32_t generations;   //Generations the board was meant to run for in all
+    uint32_t columns;
+    uint32_t rows;
+    char rule[32];
+};
+
+struct checkpointBlock
+{
+    uint32_t startX;
+    uint32_t startY;
+    uint32_t lengthX;
+    uint32_t lengthY;
+    uint64_t offset;        //Where the block's cells start in the file
+};
+
+//A binary board file mapped into memory
+struct boardFile
+{
+    struct boardFileHeader header;
+    const unsigned char *data;
+    size_t size;
+};
+
+bool isBinaryBoard(const char *start, int length);
+
+bool isByteSwapped(const char *start, int length);
+
+bool readBoardFileHeader(const char *start, int length, struct boardFileHeader *header);
+
+void initBoardFileHeader(struct boardFileHeader *header, int generations, int columns, int rows);
+
+bool mapBoardFile(const char *fileName, struct boardFile *board);
+
+void readBoardCells(const struct boardFile *board, int x, int y, int width, int height, char *cells, int cellsWidth);
+
+void unmapBoardFile(struct boardFile *board);
+
+bool readCheckpointHeader(const char *start, int length, struct checkpointHeader *header);
+
+int parseTextCells(const char *text, int length, char *cells);
+
+void printTextBoardError(long line, long column, int columns, int found);
+
+uint64_t hashCell(uint64_t seed, uint64_t index);
+
+bool randomCell(uint64_t seed, uint64_t index, double density);
+
+#endif // BOARDFILE_H_INCLUDED
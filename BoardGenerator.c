@@ -0,0 +1,82 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "BoardFile.h"
+#include "PackedBoard.h"
+
+//Writes random binary boards, for benchmarks and anything else that needs a big board without drawing one
+//Usage is BoardGenerator columns rows density seed generations outputFile [rule]. The same seed always gives the same board
+//Boards are made a row at a time, so they never have to fit in memory
+
+int main(int argc, char ** argv)
+{
+    struct boardFileHeader header;
+    FILE *output;
+    int columns;
+    int rows;
+    int generations;
+    double density;
+    uint64_t seed;
+    char *cells;
+    uint64_t *row;
+
+    if(argc != 7 && argc != 8)
+    {
+        printf("Usage: %s columns rows density seed generations outputBoard [rule]\n", argv[0]);
+        return 1;
+    }
+
+    columns = atoi(argv[1]);
+    rows = atoi(argv[2]);
+    density = atof(argv[3]);
+    seed = strtoull(argv[4], NULL, 10);
+    generations = atoi(argv[5]);
+
+    if(columns < 1 || rows < 1 || generations < 0 || density < 0 || density > 1)
+    {
+        printf("The board needs at least one column and row, no fewer than 0 generations and a density from 0 to 1\n");
+        return 1;
+    }
+
+    //The rule is checked when the board is run, this only has to make sure it fits
+    if(argc == 8 && strlen(argv[7]) >= sizeof(header.rule))
+    {
+        printf("The rule can be at most %d characters\n", (int)sizeof(header.rule) - 1);
+        return 1;
+    }
+
+    output = fopen(argv[6], "wb");
+
+    if(output == NULL)
+    {
+        printf("Could not create %s\n", argv[6]);
+        return 1;
+    }
+
+    initBoardFileHeader(&header, generations, columns, rows);
+
+    if(argc == 8)
+        strcpy(header.rule, argv[7]);
+
+    fwrite(&header, sizeof(header), 1, output);
+
+    cells = malloc(sizeof(char) * columns);
+    row = calloc(header.rowBytes, 1);
+
+    for(int y = 0; y < rows; y++)
+    {
+        for(int x = 0; x < columns; x++)
+            cells[x] = randomCell(seed, (uint64_t)y * columns + x, density);
+
+        packRow(cells, columns, row);
+        fwrite(row, header.rowBytes, 1, output);
+    }
+
+    free(cells);
+    free(row);
+    fclose(output);
+
+    return 0;
+}
@@ -1,19 +1,17 @@
-#ifndef GEOMETRYSPLITTER_H_INCLUDED
-#define GEOMETRYSPLITTER_H_INCLUDED
-
-struct partition
-{
-    int startX;
-    int startY;
-    int lengthX;
-    int lengthY;
-} ;
-
-struct partition * generateBoard(int width, int length, int* processes);
+#ifndef GEOMETRYSPLITTER_H_INCLUDED
+#define GEOMETRYSPLITTER_H_INCLUDED
 
-int * neighborList(int);
-
-#endif // GEOMETRYSPLITTER_H_INCLUDED
-
-
-
+struct partition
+{
+    int startX;
+    int startY;
+    int lengthX;
+    int lengthY;
+} ;
+
+struct partition * generateBoard(int width, int length, int* processes, int* divisionsX, int* divisionsY);
+
+//MPI_Partition.c finds its neighbors through its Cartesian topology instead, this is kept for using the splitter on its own (see README)
+void neighborList(int partitionNumber, int divisionsX, int divisionsY, int* list);
+
+#endif // GEOMETRYSPLITTER_H_INCLUDED
@@ -0,0 +1,563 @@
+#include "Hashlife.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+
+//Hashlife engine
+//The board is a quadtree whose nodes are canonical: there's only ever one node for a given square of cells, found through a hash table
+//of every node. Each node remembers where its center ends up some power of two generations later, so repeated patterns (in space or in
+//time) are only ever worked out once. The quadtree has no edge, where the other engines' boards have one that nothing outside can come
+//alive past, so big jumps are only taken while nothing can reach the edge of the board during them. Near it the board is moved on a
+//generation at a time, clearing anything born outside after each one
+
+typedef struct lifeNode
+{
+    struct lifeNode *nw;
+    struct lifeNode *ne;
+    struct lifeNode *sw;
+    struct lifeNode *se;
+    struct lifeNode *result;    //The center of the node 2^resultStep generations on, once worked out
+    struct lifeNode *next;      //Next node in the same hash bucket
+    uint64_t population;
+    int level;                  //The node is 2^level cells on a side
+    int resultStep;
+    bool marked;
+} lifeNode;
+
+//Masks of the neighbor counts a dead cell is born with and a live one survives with. Nodes only hold their results for the one rule
+static uint32_t ruleBirth;
+static uint32_t ruleSurvival;
+
+//Single cells aren't kept in the table, there are only two of them
+static lifeNode deadCell = {NULL, NULL, NULL, NULL, NULL, NULL, 0, 0, -1, true};
+static lifeNode liveCell = {NULL, NULL, NULL, NULL, NULL, NULL, 1, 0, -1, true};
+
+static lifeNode **buckets;
+static size_t numberOfBuckets;
+static size_t numberOfNodes;
+static size_t collectAt;        //Collect garbage once there are this many nodes
+static bool overBudget;
+
+static lifeNode *emptyNodes[64];
+static lifeNode *root;
+
+//Nodes in the middle of being worked out, which garbage collection has to keep along with everything under root
+static lifeNode **gcStack;
+static int gcStackSize;
+static int gcStackCapacity;
+
+static void collectGarbage(lifeNode *nw, lifeNode *ne, lifeNode *sw, lifeNode *se);
+
+static void pushNode(lifeNode *node)
+{
+    if(gcStackSize == gcStackCapacity)
+    {
+        gcStackCapacity = gcStackCapacity ? gcStackCapacity * 2 : 1024;
+        gcStack = realloc(gcStack, sizeof(lifeNode *) * gcStackCapacity);
+    }
+
+    gcStack[gcStackSize++] = node;
+}
+
+static size_t hashChildren(const lifeNode *nw, const lifeNode *ne, const lifeNode *sw, const lifeNode *se)
+{
+    uint64_t hash;
+
+    hash = (uintptr_t)nw;
+    hash = hash * 0x9E3779B97F4A7C15ULL + (uintptr_t)ne;
+    hash = hash * 0x9E3779B97F4A7C15ULL + (uintptr_t)sw;
+    hash = hash * 0x9E3779B97F4A7C15ULL + (uintptr_t)se;
+
+    return (hash ^ (hash >> 29)) & (numberOfBuckets - 1);
+}
+
+/* Doubles the hash table once it's as full as it has buckets */
+static void growTable()
+{
+    lifeNode **oldBuckets;
+    size_t oldNumberOfBuckets;
+
+    oldBuckets = buckets;
+    oldNumberOfBuckets = numberOfBuckets;
+
+    numberOfBuckets *= 2;
+    buckets = calloc(numberOfBuckets, sizeof(lifeNode *));
+
+    for(size_t b = 0; b < oldNumberOfBuckets; b++)
+    {
+        lifeNode *node = oldBuckets[b];
+
+        while(node != NULL)
+        {
+            lifeNode *next = node->next;
+            size_t hash = hashChildren(node->nw, node->ne, node->sw, node->se);
+
+            node->next = buckets[hash];
+            buckets[hash] = node;
+            node = next;
+        }
+    }
+
+    free(oldBuckets);
+}
+
+/* Returns the one node made of these four quadrants, making it if it doesn't exist yet */
+static lifeNode *findNode(lifeNode *nw, lifeNode *ne, lifeNode *sw, lifeNode *se)
+{
+    size_t hash;
+    lifeNode *node;
+
+    hash = hashChildren(nw, ne, sw, se);
+
+    for(node = buckets[hash]; node != NULL; node = node->next)
+        if(node->nw == nw && node->ne == ne && node->sw == sw && node->se == se)
+            return node;
+
+    if(numberOfNodes >= collectAt)
+    {
+        collectGarbage(nw, ne, sw, se);
+        hash = hashChildren(nw, ne, sw, se);
+    }
+
+    if(numberOfNodes >= numberOfBuckets)
+    {
+        growTable();
+        hash = hashChildren(nw, ne, sw, se);
+    }
+
+    node = malloc(sizeof(lifeNode));
+    node->nw = nw;
+    node->ne = ne;
+    node->sw = sw;
+    node->se = se;
+    node->result = NULL;
+    node->resultStep = -1;
+    node->population = nw->population + ne->population + sw->population + se->population;
+    node->level = nw->level + 1;
+    node->marked = false;
+    node->next = buckets[hash];
+    buckets[hash] = node;
+
+    numberOfNodes++;
+
+    return node;
+}
+
+static lifeNode *emptyNode(int level)
+{
+    if(emptyNodes[level] == NULL)
+        emptyNodes[level] = level ? findNode(emptyNode(level - 1), emptyNode(level - 1), emptyNode(level - 1), emptyNode(level - 1)) : &deadCell;
+
+    return emptyNodes[level];
+}
+
+static void markNode(lifeNode *node)
+{
+    if(node == NULL || node->marked)
+        return;
+
+    node->marked = true;
+    markNode(node->nw);
+    markNode(node->ne);
+    markNode(node->sw);
+    markNode(node->se);
+}
+
+/* Frees every node that isn't under root, an empty node, on the stack, or one of the four about to be made into a new node.
+   Remembered results that would be freed are forgotten */
+static void collectGarbage(lifeNode *nw, lifeNode *ne, lifeNode *sw, lifeNode *se)
+{
+    markNode(root);
+    markNode(nw);
+    markNode(ne);
+    markNode(sw);
+    markNode(se);
+
+    for(int i = 0; i < 64; i++)
+        markNode(emptyNodes[i]);
+
+    for(int i = 0; i < gcStackSize; i++)
+        markNode(gcStack[i]);
+
+    for(size_t b = 0; b < numberOfBuckets; b++)
+        for(lifeNode *node = buckets[b]; node != NULL; node = node->next)
+            if(node->marked && node->result != NULL && !node->result->marked)
+                node->result = NULL;
+
+    for(size_t b = 0; b < numberOfBuckets; b++)
+    {
+        lifeNode **link = &buckets[b];
+
+        while(*link != NULL)
+        {
+            lifeNode *node = *link;
+
+            if(node->marked)
+            {
+                node->marked = false;
+                link = &node->next;
+            }
+            else
+            {
+                *link = node->next;
+                free(node);
+                numberOfNodes--;
+            }
+        }
+    }
+
+    //If hardly anything could be freed the budget is just too small for the pattern, so it's allowed to grow rather than collect constantly
+    if(numberOfNodes > collectAt / 2)
+    {
+        if(!overBudget)
+            printf("Hashlife needs more memory than its budget, going over it\n");
+
+        overBudget = true;
+        collectAt = numberOfNodes * 2;
+    }
+}
+
+/* Works out the middle 2x2 of a 4x4 node one generation on */
+static lifeNode *calculateSmallNode(lifeNode *node)
+{
+    int cells[4][4];
+    lifeNode *quadrants[4] = {node->nw, node->ne, node->sw, node->se};
+    lifeNode *next[4];
+
+    for(int q = 0; q < 4; q++)
+    {
+        cells[(q / 2) * 2][(q % 2) * 2] = quadrants[q]->nw->population;
+        cells[(q / 2) * 2][(q % 2) * 2 + 1] = quadrants[q]->ne->population;
+        cells[(q / 2) * 2 + 1][(q % 2) * 2] = quadrants[q]->sw->population;
+        cells[(q / 2) * 2 + 1][(q % 2) * 2 + 1] = quadrants[q]->se->population;
+    }
+
+    for(int y = 1; y <= 2; y++)
+    {
+        for(int x = 1; x <= 2; x++)
+        {
+            int neighbors = 0;
+
+            for(int j = -1; j <= 1; j++)
+                for(int i = -1; i <= 1; i++)
+                    if(i || j)
+                        neighbors += cells[y + j][x + i];
+
+            next[(y - 1) * 2 + x - 1] = (((cells[y][x] ? ruleSurvival : ruleBirth) >> neighbors) & 1) ? &liveCell : &deadCell;
+        }
+    }
+
+    return findNode(next[0], next[1], next[2], next[3]);
+}
+
+static lifeNode *centerNode(lifeNode *node)
+{
+    return findNode(node->nw->se, node->ne->sw, node->sw->ne, node->se->nw);
+}
+
+static lifeNode *horizontalCenter(lifeNode *west, lifeNode *east)
+{
+    return findNode(west->ne, east->nw, west->se, east->sw);
+}
+
+static lifeNode *verticalCenter(lifeNode *north, lifeNode *south)
+{
+    return findNode(north->sw, north->se, south->nw, south->ne);
+}
+
+/* Returns the center of a node (half its size) 2^step generations on, which the node holds everything needed for as long as step is
+   at most level - 2. The node is split into nine overlapping pieces, whose centers are moved on half the time, then put together
+   into four pieces that are moved on the other half */
+static lifeNode *nodeResult(lifeNode *node, int step)
+{
+    lifeNode *pieces[9];
+    lifeNode *quarters[4];
+    int stackBase;
+
+    if(node->population == 0)
+        return emptyNode(node->level - 1);
+
+    if(node->result != NULL && node->resultStep == step)
+        return node->result;
+
+    if(node->level == 2)
+        node->result = calculateSmallNode(node);
+    else
+    {
+        stackBase = gcStackSize;
+
+        pieces[0] = node->nw;
+        pieces[1] = horizontalCenter(node->nw, node->ne);
+        pushNode(pieces[1]);
+        pieces[2] = node->ne;
+        pieces[3] = verticalCenter(node->nw, node->sw);
+        pushNode(pieces[3]);
+        pieces[4] = centerNode(node);
+        pushNode(pieces[4]);
+        pieces[5] = verticalCenter(node->ne, node->se);
+        pushNode(pieces[5]);
+        pieces[6] = node->sw;
+        pieces[7] = horizontalCenter(node->sw, node->se);
+        pushNode(pieces[7]);
+        pieces[8] = node->se;
+
+        //At full speed the first half takes half the time, otherwise all the time is spent in the second half
+        for(int i = 0; i < 9; i++)
+        {
+            pieces[i] = (step == node->level - 2) ? nodeResult(pieces[i], step - 1) : centerNode(pieces[i]);
+            pushNode(pieces[i]);
+        }
+
+        quarters[0] = findNode(pieces[0], pieces[1], pieces[3], pieces[4]);
+        pushNode(quarters[0]);
+        quarters[1] = findNode(pieces[1], pieces[2], pieces[4], pieces[5]);
+        pushNode(quarters[1]);
+        quarters[2] = findNode(pieces[3], pieces[4], pieces[6], pieces[7]);
+        pushNode(quarters[2]);
+        quarters[3] = findNode(pieces[4], pieces[5], pieces[7], pieces[8]);
+        pushNode(quarters[3]);
+
+        for(int i = 0; i < 4; i++)
+        {
+            quarters[i] = nodeResult(quarters[i], (step == node->level - 2) ? step - 1 : step);
+            pushNode(quarters[i]);
+        }
+
+        node->result = findNode(quarters[0], quarters[1], quarters[2], quarters[3]);
+
+        gcStackSize = stackBase;
+    }
+
+    node->resultStep = step;
+
+    return node->result;
+}
+
+/* Builds the node for the square of the board starting at x, y */
+static lifeNode *buildNode(const char *board, int columns, int rows, long x, long y, int level)
+{
+    lifeNode *quadrants[4];
+    long half;
+
+    if(x >= columns || y >= rows)
+        return emptyNode(level);
+
+    if(level == 0)
+        return board[y * columns + x] ? &liveCell : &deadCell;
+
+    half = 1L << (level - 1);
+
+    for(int q = 0; q < 4; q++)
+    {
+        quadrants[q] = buildNode(board, columns, rows, x + (q % 2) * half, y + (q / 2) * half, level - 1);
+        pushNode(quadrants[q]);
+    }
+
+    gcStackSize -= 4;
+
+    return findNode(quadrants[0], quadrants[1], quadrants[2], quadrants[3]);
+}
+
+/* Surrounds root with empty space, doubling its size while keeping it in the middle */
+static void expandRoot(long long *originX, long long *originY)
+{
+    lifeNode *empty;
+    lifeNode *quadrants[4];
+
+    empty = emptyNode(root->level - 1);
+
+    quadrants[0] = findNode(empty, empty, empty, root->nw);
+    pushNode(quadrants[0]);
+    quadrants[1] = findNode(empty, empty, root->ne, empty);
+    pushNode(quadrants[1]);
+    quadrants[2] = findNode(empty, root->sw, empty, empty);
+    pushNode(quadrants[2]);
+    quadrants[3] = findNode(root->se, empty, empty, empty);
+    pushNode(quadrants[3]);
+
+    *originX -= 1LL << (root->level - 1);
+    *originY -= 1LL << (root->level - 1);
+
+    root = findNode(quadrants[0], quadrants[1], quadrants[2], quadrants[3]);
+
+    gcStackSize -= 4;
+}
+
+/* Whether everything alive sits in the middle half of root, away from its edges */
+static bool rootIsCentered()
+{
+    return root->nw->nw->population + root->nw->ne->population + root->nw->sw->population
+         + root->ne->nw->population + root->ne->ne->population + root->ne->se->population
+         + root->sw->nw->population + root->sw->sw->population + root->sw->se->population
+         + root->se->ne->population + root->se->sw->population + root->se->se->population == 0;
+}
+
+/* Counts the live cells of a node at x, y that are inside the board */
+static uint64_t populationInside(lifeNode *node, long long x, long long y, long long columns, long long rows)
+{
+    long long size;
+    long long half;
+
+    size = 1LL << node->level;
+
+    if(node->population == 0 || x >= columns || y >= rows || x + size <= 0 || y + size <= 0)
+        return 0;
+
+    if(x >= 0 && y >= 0 && x + size <= columns && y + size <= rows)
+        return node->population;
+
+    half = size / 2;
+
+    return populationInside(node->nw, x, y, columns, rows) + populationInside(node->ne, x + half, y, columns, rows)
+         + populationInside(node->sw, x, y + half, columns, rows) + populationInside(node->se, x + half, y + half, columns, rows);
+}
+
+/* Returns a node at x, y with every cell outside the board killed */
+static lifeNode *clipNode(lifeNode *node, long long x, long long y, int columns, int rows)
+{
+    lifeNode *quadrants[4];
+    long long size;
+    long long half;
+
+    size = 1LL << node->level;
+
+    if(node->population == 0 || (x >= 0 && y >= 0 && x + size <= columns && y + size <= rows))
+        return node;
+
+    if(x >= columns || y >= rows || x + size <= 0 || y + size <= 0)
+        return emptyNode(node->level);
+
+    half = size / 2;
+
+    quadrants[0] = clipNode(node->nw, x, y, columns, rows);
+    pushNode(quadrants[0]);
+    quadrants[1] = clipNode(node->ne, x + half, y, columns, rows);
+    pushNode(quadrants[1]);
+    quadrants[2] = clipNode(node->sw, x, y + half, columns, rows);
+    pushNode(quadrants[2]);
+    quadrants[3] = clipNode(node->se, x + half, y + half, columns, rows);
+    pushNode(quadrants[3]);
+
+    gcStackSize -= 4;
+
+    return findNode(quadrants[0], quadrants[1], quadrants[2], quadrants[3]);
+}
+
+/* Writes the live cells of a node at x, y that are inside the board into it */
+static void writeNode(lifeNode *node, long long x, long long y, char *board, int columns, int rows)
+{
+    long long size;
+    long long half;
+
+    size = 1LL << node->level;
+
+    if(node->population == 0 || x >= columns || y >= rows || x + size <= 0 || y + size <= 0)
+        return;
+
+    if(node->level == 0)
+    {
+        board[y * columns + x] = 1;
+        return;
+    }
+
+    half = size / 2;
+
+    writeNode(node->nw, x, y, board, columns, rows);
+    writeNode(node->ne, x + half, y, board, columns, rows);
+    writeNode(node->sw, x, y + half, board, columns, rows);
+    writeNode(node->se, x + half, y + half, board, columns, rows);
+}
+
+static void freeAllNodes()
+{
+    for(size_t b = 0; b < numberOfBuckets; b++)
+    {
+        lifeNode *node = buckets[b];
+
+        while(node != NULL)
+        {
+            lifeNode *next = node->next;
+            free(node);
+            node = next;
+        }
+    }
+
+    free(buckets);
+    free(gcStack);
+
+    buckets = NULL;
+    gcStack = NULL;
+    gcStackSize = 0;
+    gcStackCapacity = 0;
+    numberOfNodes = 0;
+
+    for(int i = 0; i < 64; i++)
+        emptyNodes[i] = NULL;
+}
+
+/* Moves a board of one char per cell on by some number of generations of a rule, in jumps of a power of two generations each. The rule
+   is given as masks of the neighbor counts a cell is born and survives with, and can't have births with no neighbors, since empty space
+   would fill up. Nodes are garbage collected whenever they'd take up more than memoryBudget bytes. Cells outside the board never come
+   alive, the same as with the other engines */
+void runHashlife(char *board, int columns, int rows, long long generations, size_t memoryBudget, uint32_t birth, uint32_t survival)
+{
+    long long originX;
+    long long originY;
+    long long jump;
+    int level;
+    int step;
+
+    ruleBirth = birth;
+    ruleSurvival = survival;
+    numberOfBuckets = 1 << 16;
+    buckets = calloc(numberOfBuckets, sizeof(lifeNode *));
+    numberOfNodes = 0;
+    collectAt = memoryBudget / (sizeof(lifeNode) + sizeof(lifeNode *));
+    overBudget = false;
+    root = NULL;
+
+    for(level = 2; (1L << level) < columns || (1L << level) < rows; level++);
+
+    root = buildNode(board, columns, rows, 0, 0, level);
+    originX = 0;
+    originY = 0;
+
+    while(generations > 0 && root->population > 0)
+    {
+        //Cells spread at most one cell a generation, so a jump of 2^step is safe as long as everything alive is at least that far inside
+        //the board, or nothing outside it could have come alive in the meantime
+        for(step = 62; step > 0; step--)
+        {
+            jump = 1LL << step;
+
+            if(jump <= generations && jump <= (columns - 1) / 2 && jump <= (rows - 1) / 2
+               && populationInside(root, originX - jump, originY - jump, columns - 2 * jump, rows - 2 * jump) == root->population)
+                break;
+        }
+
+        //Room for the pattern to grow by 2^step cells on every side, plus the room the result needs
+        while(root->level < step + 2 || !rootIsCentered())
+            expandRoot(&originX, &originY);
+
+        expandRoot(&originX, &originY);
+
+        originX += 1LL << (root->level - 2);
+        originY += 1LL << (root->level - 2);
+        root = nodeResult(root, step);
+
+        //A single generation may have been right up against the edge, where anything born outside would have stayed dead
+        if(step == 0)
+            root = clipNode(root, originX, originY, columns, rows);
+
+        generations -= 1LL << step;
+    }
+
+    for(long i = 0; i < (long)columns * rows; i++)
+        board[i] = 0;
+
+    writeNode(root, originX, originY, board, columns, rows);
+
+    freeAllNodes();
+    root = NULL;
+}
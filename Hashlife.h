@@ -0,0 +1,10 @@
+#ifndef HASHLIFE_H_INCLUDED
+#define HASHLIFE_H_INCLUDED
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+void runHashlife(char *board, int columns, int rows, long long generations, size_t memoryBudget, uint32_t birth, uint32_t survival);
+
+#endif // HASHLIFE_H_INCLUDED
@@ -0,0 +1,83 @@
+#include "LargerKernel.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+//Larger-than-Life kernel for the one-char-per-cell board, for rules that reach more than one cell out
+//For each row the rows within reach are added into column totals, then a running total of the columns within reach slides along
+//the row, adding the column coming into reach and dropping the one leaving it. A cell then costs a couple of additions however
+//wide the rule is, rather than a read of every cell in the square around it
+
+//Scratch row of column totals, grown as needed. Each thread has its own
+static int *columnTotals;
+static int columnTotalsSize;
+#pragma omp threadprivate(columnTotals, columnTotalsSize)
+
+static int radius;
+static int birthLow;
+static int birthHigh;
+static int survivalLow;
+static int survivalHigh;
+
+//Regions smaller than this many cells are done by a single thread
+#define PARALLEL_CELLS 16384
+
+/* Takes the rule's radius and ranges. Has to be done before anything is calculated */
+void initLargerKernel(const struct lifeRule *rule)
+{
+    radius = rule->radius;
+    birthLow = rule->birthLow;
+    birthHigh = rule->birthHigh;
+    survivalLow = rule->survivalLow;
+    survivalHigh = rule->survivalHigh;
+}
+
+/* Updates the cells x0 to x1 of rows y0 to y1 of a board whose rows are width chars apart. Everything within the radius of them is
+   only read, so the board has to reach at least that far past them on every side */
+void calculateLargerBoard(const char *board, char *nextBoard, int width, int x0, int y0, int x1, int y1)
+{
+    #pragma omp parallel if((long)(x1 - x0 + 1) * (y1 - y0 + 1) >= PARALLEL_CELLS)
+    {
+        if(columnTotalsSize < width)
+        {
+            free(columnTotals);
+            columnTotals = malloc(sizeof(int) * width);
+            columnTotalsSize = width;
+        }
+
+        #pragma omp for
+        for(int y = y0; y <= y1; y++)
+        {
+            const char *middle = board + y * width;
+            int total;
+
+            memset(columnTotals + x0 - radius, 0, sizeof(int) * (x1 - x0 + 1 + 2 * radius));
+
+            for(int j = -radius; j <= radius; j++)
+            {
+                const char *row = middle + j * width;
+
+                for(int x = x0 - radius; x <= x1 + radius; x++)
+                    columnTotals[x] += row[x];
+            }
+
+            total = 0;
+
+            for(int x = x0 - radius; x < x0 + radius; x++)
+                total += columnTotals[x];
+
+            //The ranges are checked with one unsigned compare each, totals below the low end wrap round to something huge
+            for(int x = x0; x <= x1; x++)
+            {
+                total += columnTotals[x + radius];
+
+                if(middle[x])
+                    nextBoard[y * width + x] = (unsigned)(total - survivalLow) <= (unsigned)(survivalHigh - survivalLow);
+                else
+                    nextBoard[y * width + x] = (unsigned)(total - birthLow) <= (unsigned)(birthHigh - birthLow);
+
+                total -= columnTotals[x - radius];
+            }
+        }
+    }
+}
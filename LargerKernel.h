@@ -0,0 +1,10 @@
+#ifndef LARGERKERNEL_H_INCLUDED
+#define LARGERKERNEL_H_INCLUDED
+
+#include "Rule.h"
+
+void initLargerKernel(const struct lifeRule *rule);
+
+void calculateLargerBoard(const char *board, char *nextBoard, int width, int x0, int y0, int x1, int y1);
+
+#endif // LARGERKERNEL_H_INCLUDED
@@ -0,0 +1,92 @@
+#include "LookupKernel.h"
+
+#include <stdbool.h>
+
+//Lookup table kernel for the one-char-per-cell board
+//Cells are worked out two by two. The 4x4 block of cells around a 2x2 block is packed into 16 bits, a nibble per column with
+//bit k holding row k, and a 65536 entry table gives the next generation of the middle 2x2 straight from that. Moving two columns
+//along keeps the two nibbles still needed and adds two new ones, so no vector instructions are needed to beat isAlive()
+
+//Next generation of the middle 2x2 of every 4x4 block. Bits 0 and 1 are the left column's top and bottom cells, bits 2 and 3 the right's.
+//It's built for one rule, so the rule costs nothing once it's built
+static unsigned char nextBlock[65536];
+static bool tableBuilt;
+
+//Regions smaller than this many cells are done by a single thread
+#define PARALLEL_CELLS 16384
+
+/* Whether the cell in column i, row k of a 4x4 block is alive next generation, by the masks of neighbor counts it's born and survives with */
+static int blockCellLives(int block, int i, int k, uint32_t birth, uint32_t survival)
+{
+    int total;
+
+    total = 0;
+
+    for(int dj = -1; dj <= 1; dj++)
+        for(int di = -1; di <= 1; di++)
+            if(di != 0 || dj != 0)
+                total += (block >> ((i + di) * 4 + k + dj)) & 1;
+
+    return ((((block >> (i * 4 + k)) & 1) ? survival : birth) >> total) & 1;
+}
+
+/* Fills in the table for a rule. Has to be done before any threads use it */
+void initLookupKernel(uint32_t birth, uint32_t survival)
+{
+    for(int block = 0; block < 65536; block++)
+        nextBlock[block] = blockCellLives(block, 1, 1, birth, survival) | blockCellLives(block, 1, 2, birth, survival) << 1
+                           | blockCellLives(block, 2, 1, birth, survival) << 2 | blockCellLives(block, 2, 2, birth, survival) << 3;
+
+    tableBuilt = true;
+}
+
+/* Updates the cells x0 to x1 of rows y0 to y1 of a board whose rows are width chars apart. Everything around them is only read.
+   An odd column or row left over at the end is done as half a block, with the column or row past the one around it taken as dead */
+void calculateLookupBoard(const char *board, char *nextBoard, int width, int x0, int y0, int x1, int y1)
+{
+    if(!tableBuilt)
+        initLookupKernel(LIFE_BIRTH, LIFE_SURVIVAL);
+
+    #pragma omp parallel for if((long)(x1 - x0 + 1) * (y1 - y0 + 1) >= PARALLEL_CELLS)
+    for(int y = y0; y <= y1; y += 2)
+    {
+        const char *above = board + (y - 1) * width;
+        const char *top = above + width;
+        const char *bottom = top + width;
+        const char *below = (y < y1) ? bottom + width : bottom;
+        int rowMask = (y < y1) ? 15 : 7;
+        int block;
+        int next;
+
+        #define COLUMN_NIBBLE(x) ((above[x] | top[x] << 1 | bottom[x] << 2 | below[x] << 3) & rowMask)
+
+        block = COLUMN_NIBBLE(x0 - 1) | COLUMN_NIBBLE(x0) << 4;
+
+        for(int x = x0; x <= x1; x += 2)
+        {
+            block |= COLUMN_NIBBLE(x + 1) << 8;
+
+            if(x < x1)
+                block |= COLUMN_NIBBLE(x + 2) << 12;
+
+            next = nextBlock[block];
+
+            nextBoard[y * width + x] = next & 1;
+
+            if(y < y1)
+                nextBoard[(y + 1) * width + x] = (next >> 1) & 1;
+
+            if(x < x1)
+            {
+                nextBoard[y * width + x + 1] = (next >> 2) & 1;
+
+                if(y < y1)
+                    nextBoard[(y + 1) * width + x + 1] = next >> 3;
+            }
+
+            block >>= 8;
+        }
+
+        #undef COLUMN_NIBBLE
+    }
+}
@@ -0,0 +1,12 @@
+#ifndef LOOKUPKERNEL_H_INCLUDED
+#define LOOKUPKERNEL_H_INCLUDED
+
+#include <stdint.h>
+
+#include "Rule.h"
+
+void initLookupKernel(uint32_t birth, uint32_t survival);
+
+void calculateLookupBoard(const char *board, char *nextBoard, int width, int x0, int y0, int x1, int y1);
+
+#endif // LOOKUPKERNEL_H_INCLUDED
@@ -1,9 +1,23 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdbool.h>
+#include <string.h>
+#include <ctype.h>
+#include <limits.h>
 #include <mpi.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 #include "GeometrySplitter.h"
+#include "PackedBoard.h"
+#include "SimdKernel.h"
+#include "LookupKernel.h"
+#include "LargerKernel.h"
+#include "Rule.h"
+#include "BoardFile.h"
+#include "Hashlife.h"
+#include "Timing.h"
 
 //Project 3
 //Christopher Parish and Eli Pinkerton
@@ -17,6 +31,11 @@ char* localBoard;
 char* nextGenBoard;
 char* masterBoard;
 
+//Bit-packed versions of the local boards, used instead of localBoard/nextGenBoard by the packed engine
+uint64_t* localPackedBoard;
+uint64_t* nextGenPackedBoard;
+int localBoard_RowWords;
+
 //Used for masterBoard specifications
 int masterBoard_columns;
 int masterBoard_rows;
@@ -25,16 +44,197 @@ int masterBoard_rows;
 struct partition myCoords;
 
 int numberOfGenerations;
-int myNeighborIDs[8];
-MPI_Status lastStatus; //Handles to async call status messages
-MPI_Request lastRequest;
+int totalGenerations;   //Generations the board file asked for, numberOfGenerations counts down from it
+int myNeighborIDs[8];   //Ranks in cartComm of the neighbors NW N NE W E SW S SE, -1 where there's no neighbor
+int myPartition;        //Index of our partition in partitionArray, -1 if we don't have one
+int *partitionOwners;   //Rank in boardComm holding each partition, only kept by the master
+int partitionsX;        //Shape of the grid of partitions
+int partitionsY;
+
+//Ranks only get left without a partition when the board can't be split into a grid of that many. They help load the board, then stop
+MPI_Comm boardComm;     //Every rank with a partition, with the same ranks as in MPI_COMM_WORLD. MPI_COMM_NULL on the rest
+
+//The working ranks are laid out in a Cartesian grid matching the partitions, which lets MPI place them on the machine as it sees fit
+MPI_Comm cartComm;      //MPI_COMM_NULL on ranks without a partition
+bool hasPartition;
 
 int localBoard_Size;
+int localBoard_Width;    //Padded size of the local board, haloDepth ghost cells on each side
+int localBoard_Height;
+int haloDepth;          //Width of the ghost region, haloGenerations times the rule's radius
+int haloGenerations;    //Edges are exchanged every haloGenerations generations, each of which uses up a radius of the ghost region
+
+//Regions smaller than this are computed by a single thread, splitting them costs more than it saves
+#define PARALLEL_CELLS 16384
+
+//Halo exchange over a neighborhood collective, see setupHaloExchange()
+MPI_Comm haloComm;                  //Graph of each partition and its (up to) eight neighbors
+int numberOfNeighbors;
+int neighborDirections[8];          //Direction of each of haloComm's neighbors, in the order haloComm lists them
+int haloCounts[8];
+MPI_Datatype haloTypes[8];
+MPI_Aint haloSendDispls[2][8];      //Absolute addresses of the edges, one set per board buffer since localBoard and nextGenBoard trade places every generation
+MPI_Aint haloRecvDispls[2][8];
+MPI_Request haloRequest;
+#if MPI_VERSION >= 4
+MPI_Request haloPersistentRequests[2];
+#endif
+int currentBoard;                   //Which of the two board buffers localBoard is
+MPI_Datatype edgeTypes[8];          //Shape of the edge in each direction on a char board
+uint64_t* sendEdges[8];             //Staging buffers for packed edges
+uint64_t* recvEdges[8];
+
+//Neighbors on the same node aren't sent edges. The node's ranks keep both their board buffers in one shared memory window, and once a
+//neighbor says its board is ready its edge is copied straight out of it into our ghost region. Only neighbors on other nodes get messages
+#define SHARED_READY_TAG 0          //Sent with which of the two buffers our board is in, once it can be read
+#define SHARED_DONE_TAG 1           //Sent once we've finished reading a neighbor's board, so it can be written again
+bool sharedHalo;                    //Whether neighbors on the same node may share boards at all, -noshared turns it off
+MPI_Comm nodeComm;                  //Ranks of cartComm on our node, MPI_COMM_NULL when we don't share boards with any
+MPI_Win boardWindow;                //Every board buffer on the node, MPI_WIN_NULL when ours are allocated privately
+void* boardBuffers;                 //Where our two board buffers start, one after the other
+int numberOfSharedNeighbors;
+int sharedNeighbors[8];             //Index in haloComm of each neighbor on our node
+int sharedRanks[8];                 //Rank in nodeComm of each haloComm neighbor, MPI_UNDEFINED for those on other nodes
+char* sharedBoards[8];              //Where each of those neighbors' two buffers start, in our address space
+MPI_Aint sharedBoardBytes[8];       //And how big one of them is
+struct partition sharedPartitions[8];   //Each one's partition, to find its edges in its board
+int sharedReadyBoards[8];           //Which of its two buffers each said its board is in
+MPI_Request sharedReadyRequests[16];
+MPI_Request sharedDoneRequests[16];
+bool sharedReadsPending;            //Whether the neighbors may still be reading the board we last exchanged
+
+//Active tiles. The padded board is cut into tileSize square tiles, and a tile is only recomputed if something in it or in one of the
+//eight around it changed last generation, since otherwise it's bound to come out the same as it already is in the other buffer
+int tileSize;                       //0 (the default) recomputes every cell every generation
+int tilesX;
+int tilesY;
+unsigned char* tileChanged;         //Whether each tile differs between localBoard and nextGenBoard
+unsigned char* nextTileChanged;     //Built up as the next generation is computed
+int changedTiles;                   //How many tiles are marked in tileChanged, so a quiet board can skip looking at them
+int nextChangedTiles;
+int* tileWork;                      //Times each tile has been computed since the last rebalance
+
+//Temporal blocking. Each tile is taken a whole exchange's worth of generations ahead in a scratch copy small enough to stay in
+//cache, instead of the whole board being swept once per generation. The tiles double as the cache blocks and -halo sets the depth
+bool temporalBlocking;
+
+//With active tiles an edge only goes out if it changed since the last exchange, and the neighbor puts back the copy it kept
+int edgeChanged[8];                 //Per haloComm neighbor, whether the edge we send has changed
+int ghostChanged[8];                //And whether the one coming from it has
+void* lastEdges[8];                 //Each edge as it was last sent, by direction
+char* lastGhosts[8];                //Each ghost region as it was last received, by direction. Packed boards keep theirs in recvEdges
+bool haloPrimed;                    //Whether every edge has been sent at least once
 
 char** allocatedMemory; //Array that collects pointers to memory to be free after each generation
 int numberOfMemoryAllocations;
 
-//Message types
+//Ways of storing and updating the local board
+typedef enum
+{
+    CELL_ENGINE,    //One char per cell, updated through isAlive(), or with running totals for rules that reach further
+    PACKED_ENGINE,  //64 cells per word, updated with bitwise adders
+    SIMD_ENGINE,    //One char per cell, updated a row at a time with vector instructions
+    LOOKUP_ENGINE,  //One char per cell, updated two by two from a table of every 4x4 block
+    HASHLIFE_ENGINE //The whole board on the master as a memoized quadtree, jumping ahead many generations at a time
+} engineType;
+
+engineType engine;
+simdISA maximumISA;
+struct lifeRule rule;   //Rule the board is run with
+char* ruleText;         //Rule given with -rule, NULL to go by the board file
+char boardRule[32];     //Rule the board file or checkpoint says it's for
+int threadsPerRank;     //0 leaves it to OpenMP (OMP_NUM_THREADS or one per core)
+int hashlifeMegabytes;  //Memory the hashlife engine keeps its nodes in before collecting garbage
+char* boardFileName;
+bool randomBoard;       //Make the board up from randomSeed instead of reading boardFileName
+double randomDensity;   //Fraction of a random board's cells that start alive
+uint64_t randomSeed;
+char* outputFileName;   //Where the final board is written, NULL to print it instead
+bool quiet;             //Print a line of timings at the end instead of the boards, for benchmarks
+char* traceFileName;    //Where a Chrome trace of every phase goes when built with GOL_TIMING, NULL for none
+double runSeconds;      //Wall time spent running the generations
+int generationsToRun;   //Generations this run, fewer than totalGenerations after a restart
+
+//Rebalancing. Every so often the time each rank spent computing is compared, and if the busiest is too far over the average the
+//partition boundaries are moved to even the work out
+#define REBALANCE_THRESHOLD 1.1     //How far over the average the busiest rank can be before it's worth moving cells around
+int balanceGenerations;             //Consider rebalancing every this many generations, 0 never to
+double computeSeconds;              //Time spent computing since the last rebalance
+
+//Checkpoints are written to checkpointFileName.0 and .1 in turn, so there's always a complete one even if a run is cut off partway through writing
+char* checkpointFileName;           //NULL when not checkpointing
+char* restartFileName;              //Checkpoint to carry on from in place of a board file, NULL to start from boardFileName
+int checkpointGenerations;          //Checkpoint every this many generations
+double checkpointSeconds;           //Or every this many seconds, 0 to go by generations
+MPI_File checkpointFiles[2];        //Opened at the first checkpoint and kept open to the end of the run
+bool checkpointFilesOpen;
+MPI_Request checkpointRequests[2];
+MPI_Request checkpointHeaderRequests[2];
+char* checkpointHeaders[2];         //The master's header and block table for each file, kept until they've been written
+bool checkpointPending[2];          //Whether a checkpoint is still being written to each file
+bool checkpointBlank[2];            //Whether each file's magic is known to be blank on disk, so it's safe to write a checkpoint over
+int checkpointGenerationWritten[2];
+uint64_t* checkpointBuffers[2];     //Our cells are copied into these to be written from
+int checkpointSlot;                 //Which file the next checkpoint goes to
+struct checkpointBlock* checkpointBlocks;  //Block table of the checkpoint being restarted from
+int numberOfCheckpointBlocks;
+
+//With a time limit only the master's clock counts. It decides every CHECKPOINT_POLL generations and everyone acts on that CHECKPOINT_POLL generations later
+#define CHECKPOINT_POLL 16
+MPI_Request checkpointPollRequest;
+bool checkpointPollPending;
+int checkpointPollDecision;
+double lastCheckpointTime;
+
+//Cycle detection. Every cycleGenerations generations each rank hashes its cells and the hashes are summed with a nonblocking allreduce,
+//which is only waited on the next time round. A sum matching one of the last cycleWindow means the board is repeating itself. Each
+//board gets two hashes with different seeds, reduced together, and both have to match, so a single collision can't pass for a cycle
+#define CYCLE_HASH_SEED 0
+#define CYCLE_CONFIRM_SEED 0x5851F42D4C957F2DULL
+int cycleWindow;                    //Hashes each new one is compared with, 0 not to look for cycles
+int cycleGenerations;
+uint64_t* cycleHashes;              //Ring of the last cycleWindow pairs of hashes of the whole board
+int* cycleHashGenerations;          //The generation each was taken after
+int numberOfCycleHashes;            //Taken so far, the ring holds the last cycleWindow of them
+MPI_Request cycleRequest;
+bool cyclePending;
+uint64_t cycleLocalHash[2];
+uint64_t cycleGlobalHash[2];
+int cycleHashGeneration;            //Generation the hash in flight was taken after
+
+//Statistics. Every statsGenerations generations each rank counts its live cells, births and deaths and finds the box around its
+//live cells, and they're reduced onto the master with nonblocking reductions that are finished the next time round
+char* statsFileName;                //CSV the master appends a line to each time, NULL for no statistics
+int statsGenerations;
+FILE* statsFile;
+MPI_Request statsRequests[2];
+bool statsPending;
+long long statsCounts[3];           //Live cells, births and deaths of ours
+long long statsTotals[3];
+int statsBox[4];                    //Smallest x and y and the negated largest x and y of our live cells, so all four reduce with MPI_MIN
+int statsBoxes[4];
+int statsGeneration;                //Generation the statistics in flight are for
+
+//How much of the start of the file is searched for the header and for the end of the first row
+#define HEADER_BYTES 256
+
+//Board files are either text, read by every rank at once with MPI-IO, or binary, which every rank maps into memory
+typedef enum
+{
+    TEXT_BOARD,
+    BINARY_BOARD,
+    CHECKPOINT_BOARD,   //Restarting from a checkpoint
+    RANDOM_BOARD        //Made up by every rank from a seed, there's no file
+} boardFormatType;
+
+boardFormatType boardFormat;
+MPI_File boardFile;
+MPI_Offset boardDataStart;  //Offset of the first cell in the file
+int boardRowStride;         //Bytes from the start of one row in the file to the start of the next, line ending included
+int boardFirstLine;         //Line of a text board that the first row is on, for error messages
+char boardRowEnding[HEADER_BYTES];  //What comes after every row of a text board but the last, "\n" or "\r\n" usually
+
+//Neighbor directions
 typedef enum
 {
     NW_UPDATE,
@@ -44,502 +244,3390 @@ typedef enum
     E_UPDATE,
     SW_UPDATE,
     S_UPDATE,
-    SE_UPDATE,
-    BOUNDS_MESSAGE,
-    GENERATION_MESSAGE,
-    NEIGHBORLIST_MESSAGE,
-    BOARD_MESSAGE,
-    PARTITION_MESSAGE
+    SE_UPDATE
 } tagType;
 
-bool isAlive(int x, int y); //Prototypes
+bool isAlive(const char *board, int width, int height, int x, int y); //Prototypes
 void swapBoards();
 
 //Treats the local board as if it's a two dimensional array
 char getArray(int x, int y)
 {
-    return localBoard[x + (y * (myCoords.lengthX + 2))];
+    return localBoard[x + (y * localBoard_Width)];
 }
 
 void setNextArray(int x, int y, int value)
 {
-    nextGenBoard[x + (y * (myCoords.lengthX + 2))] = value;
+    nextGenBoard[x + (y * localBoard_Width)] = value;
 }
 
-/* Frees all known allocated memory */
-void freeMemory()
+/* Gives the step across (-1, 0, 1 for west, middle, east) and down (north, middle, south) to the neighbor in some direction */
+void directionOffset(int direction, int *dx, int *dy)
 {
-    for(int i = 0; i < numberOfMemoryAllocations; i++)
-        free(allocatedMemory[i]);
+    *dx = (direction < 3 ? direction : (direction < 5 ? (direction - 3) * 2 : direction - 5)) - 1;
+    *dy = (direction < 3 ? 0 : (direction < 5 ? 1 : 2)) - 1;
 }
 
-/* Parses the input file character by character. Assumes proper file format of ITERATIONS\bCOLUMNS\bROWS\bARRAY_STUFF. Sets the resulting data to *currentGenBoard */
-void parseFile(int argc, char ** argv)
+/* Finds the rectangle of some partition's local board exchanged with its neighbor in some direction (NW N NE W E SW S SE).
+   The ghost version is where the neighbor's cells land, the other is the edge of the partition's own cells that they need */
+void partitionEdgeRegion(const struct partition *piece, int direction, bool ghost, int *x, int *y, int *width, int *height)
 {
-    int numberOfProcesses;
-
-    //Keeps track of the total number of *s and .s in the file
-    int counter;
+    int column;
+    int row;
 
-    //Keeps track of the current character being read from the file
-    char currentChar;
+    directionOffset(direction, &column, &row);
+    column++;
+    row++;
 
-    MPI_Comm_size(MPI_COMM_WORLD, &numberOfProcesses);
-    counter = 0;
+    //Column and row are 0, 1, 2 for west/north, middle, east/south. Corners are haloDepth by haloDepth
+    *width = (column == 1) ? piece->lengthX : haloDepth;
+    *height = (row == 1) ? piece->lengthY : haloDepth;
 
-    FILE * filePtr = fopen(argv[1], "r");
-
-    //Breaks if the user pointed to a file that doesn't exist
-    if(filePtr == NULL)
+    if(ghost)
     {
-        printf("Could not find file! Please restart and retry.");
-        exit(1);
+        *x = (column == 0) ? 0 : (column == 1 ? haloDepth : haloDepth + piece->lengthX);
+        *y = (row == 0) ? 0 : (row == 1 ? haloDepth : haloDepth + piece->lengthY);
+    }
+    else
+    {
+        *x = (column == 2) ? piece->lengthX : haloDepth;
+        *y = (row == 2) ? piece->lengthY : haloDepth;
     }
+}
+
+/* The same for our own local board */
+void edgeRegion(int direction, bool ghost, int *x, int *y, int *width, int *height)
+{
+    partitionEdgeRegion(&myCoords, direction, ghost, x, y, width, height);
+}
+
+/* Number of words needed to carry a rectangle of cells from the packed board */
+int packedEdgeWords(int width, int height)
+{
+    return (width * height + CELLS_PER_WORD - 1) / CELLS_PER_WORD;
+}
 
-    //Reads in the generations, rows, and columns to the global variables
-    fscanf(filePtr, "%d", &numberOfGenerations);
-    fscanf(filePtr, "%d", &masterBoard_columns);
-    fscanf(filePtr, "%d", &masterBoard_rows);
+/* Cuts the padded board into tiles, all marked as changed so the first generation computes everything */
+void setupTiles()
+{
+    if(tileSize == 0)
+        return;
 
-    actualPartitions = numberOfProcesses;
+    tilesX = (localBoard_Width + tileSize - 1) / tileSize;
+    tilesY = (localBoard_Height + tileSize - 1) / tileSize;
 
-    //Allocates some memory based on the number of rows and columns found in the input file
-    masterBoard = malloc(masterBoard_rows * masterBoard_columns * sizeof(char));
+    tileChanged = malloc(sizeof(unsigned char) * tilesX * tilesY);
+    nextTileChanged = calloc(tilesX * tilesY, sizeof(unsigned char));
+    tileWork = calloc(tilesX * tilesY, sizeof(int));
 
-    //Cycles through the contents of the file character by character. Breaks when the assumed total number of symbols has been found
-    while(counter < (masterBoard_rows * masterBoard_columns))
-    {
-        //Checks to see if there aren't enough relevant characters in the file
-        if(fscanf(filePtr, "%c", &currentChar) == EOF)
-        {
-            printf("Your file specification's jacked up, might want to check it out.");
-            exit(1);
-        }
+    memset(tileChanged, 1, sizeof(unsigned char) * tilesX * tilesY);
+    changedTiles = tilesX * tilesY;
+    nextChangedTiles = 0;
+}
+
+void freeTiles()
+{
+    free(tileChanged);
+    free(nextTileChanged);
+    free(tileWork);
+}
+
+/* Whether anything in a tile or the eight around it changed last generation */
+bool tileActive(int tileX, int tileY)
+{
+    for(int j = tileY - 1; j <= tileY + 1; j++)
+        for(int i = tileX - 1; i <= tileX + 1; i++)
+            if(i >= 0 && j >= 0 && i < tilesX && j < tilesY && tileChanged[i + j * tilesX])
+                return true;
 
-        if(currentChar == 42)   //Writes the character "1" if the value of the current character is a "*"
+    return false;
+}
+
+/* Marks every tile touching a rectangle of the board as changed */
+void markTiles(int x, int y, int width, int height)
+{
+    for(int j = y / tileSize; j <= (y + height - 1) / tileSize; j++)
+        for(int i = x / tileSize; i <= (x + width - 1) / tileSize; i++)
         {
-            masterBoard[counter] = 1;
-            counter++;
+            if(!tileChanged[i + j * tilesX])
+                changedTiles++;
+
+            tileChanged[i + j * tilesX] = 1;
         }
-        else if(currentChar == 46)   //Writes the character "0" if the value of the current character is a "."
+}
+
+/* Whether the cells x0 to x1 of rows y0 to y1 came out any different in nextGenBoard than they are in localBoard */
+bool regionChanged(int x0, int y0, int x1, int y1)
+{
+    for(int j = y0; j <= y1; j++)
+    {
+        if(engine == PACKED_ENGINE)
         {
-            masterBoard[counter] = 0;
-            counter++;
+            //Whole words are compared, so cells either side of the region that differ only ever cost an extra recompute
+            for(int w = x0 / CELLS_PER_WORD; w <= x1 / CELLS_PER_WORD; w++)
+                if(localPackedBoard[j * localBoard_RowWords + w] != nextGenPackedBoard[j * localBoard_RowWords + w])
+                    return true;
         }
+        else if(memcmp(localBoard + j * localBoard_Width + x0, nextGenBoard + j * localBoard_Width + x0, x1 - x0 + 1) != 0)
+            return true;
     }
 
-    fclose(filePtr);
+    return false;
 }
 
-/* Called when the final board configurations have been calculated, all processes submit their sections for gather */
-void finalizeBoard()
+/* Builds the halo exchange once. The neighbors become a distributed graph communicator, so each exchange is a single
+   neighborhood collective instead of eight sends and receives, and MPI can schedule the messages however suits it.
+   Char boards send and receive straight out of and into the board using a datatype per edge. Packed edges aren't
+   addressable, so they go through staging buffers that are packed before and unpacked after each exchange.
+   Neighbors on our node are still in the graph, but exchange nothing through it, see finishSharedExchange() */
+void setupHaloExchange()
 {
-    int size;
+    int x;
+    int y;
+    int width;
+    int height;
+    int sets;
+    int neighbors[8];
+    int weights[8];
+    int coords[2];
+    char *boards[2];
+    MPI_Group cartGroup;
+    MPI_Group nodeGroup;
+    MPI_Aint bytes;
+    int unit;
+
+    currentBoard = 0;
+    haloPrimed = false;
+    boards[0] = localBoard;
+    boards[1] = nextGenBoard;
+    sets = (engine == PACKED_ENGINE) ? 1 : 2;
+
+    numberOfNeighbors = 0;
+
+    for(int j = 0; j < 8; j++)
+    {
+        if(myNeighborIDs[j] > -1)
+        {
+            neighborDirections[numberOfNeighbors] = j;
+            weights[numberOfNeighbors] = 1;
+            neighbors[numberOfNeighbors++] = myNeighborIDs[j];
+        }
+    }
 
-    if(!identity) //If we are the master (process 0)
+    //The ranks were already placed by MPI_Cart_create, so no reordering here.
+    //Our edge facing direction j lands in the neighbor's ghost region on the opposite side (7 - j), which is the slot it lists us in.
+    //Every edge weighs the same, but they're given as weights rather than MPI_UNWEIGHTED, which some mpi.h declare as a zero length array
+    MPI_Dist_graph_create_adjacent(cartComm, numberOfNeighbors, neighbors, weights, numberOfNeighbors, neighbors, weights, MPI_INFO_NULL, 0, &haloComm);
+
+    numberOfSharedNeighbors = 0;
+    sharedReadsPending = false;
+
+    for(int n = 0; n < numberOfNeighbors; n++)
+        sharedRanks[n] = MPI_UNDEFINED;
+
+    //Finds which neighbors are on our node, and where their boards are
+    if(boardWindow != MPI_WIN_NULL)
     {
-        char* incomingBoard;
+        MPI_Comm_group(cartComm, &cartGroup);
+        MPI_Comm_group(nodeComm, &nodeGroup);
+        MPI_Group_translate_ranks(cartGroup, numberOfNeighbors, neighbors, nodeGroup, sharedRanks);
+        MPI_Group_free(&cartGroup);
+        MPI_Group_free(&nodeGroup);
 
-        for(int i = 0; i < actualPartitions; i++)//For each slave process
+        for(int n = 0; n < numberOfNeighbors; n++)
         {
-            size = (partitionArray[i].lengthX + 2) * (partitionArray[i].lengthY + 2);
-            incomingBoard = malloc(sizeof(char) * size);
+            if(sharedRanks[n] == MPI_UNDEFINED)
+                continue;
 
-            MPI_Recv(incomingBoard, size, MPI_CHAR, i, BOARD_MESSAGE, MPI_COMM_WORLD, &lastStatus);//Recieve their board
+            MPI_Win_shared_query(boardWindow, sharedRanks[n], &bytes, &unit, &sharedBoards[n]);
 
-            for(int k = 0; k < partitionArray[i].lengthY; k++)
-            {
-                for(int j = 0; j < partitionArray[i].lengthX; j++)
-                {
-                    int clientEquivLocation = ( (k+1) * (partitionArray[i].lengthX+2) + (j+1) ); //Compute the location in the slave board we are interested in
+            MPI_Cart_coords(cartComm, neighbors[n], 2, coords);
+            sharedPartitions[n] = partitionArray[coords[0] * partitionsX + coords[1]];
 
-                    masterBoard[ j + partitionArray[i].startX + ( ( k+partitionArray[i].startY ) * masterBoard_columns )] = incomingBoard[clientEquivLocation]; //compute and store that slave location in the appropriate master board location
-                }
-            }
+            //Its second buffer starts right after the first, whose size goes by its partition. The window may have rounded its part up
+            width = sharedPartitions[n].lengthX + 2 * haloDepth;
+            height = sharedPartitions[n].lengthY + 2 * haloDepth;
+            sharedBoardBytes[n] = (engine == PACKED_ENGINE) ? sizeof(uint64_t) * packedRowWords(width) * height : sizeof(char) * width * height;
 
-            free(incomingBoard);
+            sharedNeighbors[numberOfSharedNeighbors++] = n;
         }
+    }
+
+    for(int n = 0; n < numberOfNeighbors; n++)
+    {
+        int j = neighborDirections[n];
 
-        printf("\nFinal board configuration: \n");
+        //The edge we send and the ghost region we fill in a direction have the same shape
+        edgeRegion(j, false, &x, &y, &width, &height);
 
-        for(int i = 0; i < masterBoard_columns * masterBoard_rows; i++)//Print out the board
+        if(tileSize > 0)
         {
-            if(masterBoard[i] == 1)
-                printf("*");
-            else
-                printf(".");
-            if((i + 1) % (masterBoard_columns) == 0)
-                printf("\n");
+            lastEdges[j] = malloc(engine == PACKED_ENGINE ? sizeof(uint64_t) * packedEdgeWords(width, height) : sizeof(char) * width * height);
+
+            if(engine != PACKED_ENGINE)
+                lastGhosts[j] = malloc(sizeof(char) * width * height);
         }
 
-        freeMemory();
+        if(engine == PACKED_ENGINE)
+        {
+            sendEdges[j] = malloc(sizeof(uint64_t) * packedEdgeWords(width, height));
+            recvEdges[j] = malloc(sizeof(uint64_t) * packedEdgeWords(width, height));
+
+            haloCounts[n] = (sharedRanks[n] == MPI_UNDEFINED) ? packedEdgeWords(width, height) : 0;
+            haloTypes[n] = MPI_UINT64_T;
+            MPI_Get_address(sendEdges[j], &haloSendDispls[0][n]);
+            MPI_Get_address(recvEdges[j], &haloRecvDispls[0][n]);
+            continue;
+        }
+
+        if(height == 1)
+            MPI_Type_contiguous(width, MPI_CHAR, &edgeTypes[j]);//Single rows (and corners) are contiguous
+        else
+            MPI_Type_vector(height, width, localBoard_Width, MPI_CHAR, &edgeTypes[j]);//Anything taller strides down the board
+
+        MPI_Type_commit(&edgeTypes[j]);
+
+        haloCounts[n] = (sharedRanks[n] == MPI_UNDEFINED) ? 1 : 0;
+        haloTypes[n] = edgeTypes[j];
+
+        for(int k = 0; k < sets; k++)
+        {
+            edgeRegion(j, false, &x, &y, &width, &height);
+            MPI_Get_address(boards[k] + x + y * localBoard_Width, &haloSendDispls[k][n]);
 
-        MPI_Barrier(MPI_COMM_WORLD); //wait here until everyone is done
+            edgeRegion(j, true, &x, &y, &width, &height);
+            MPI_Get_address(boards[k] + x + y * localBoard_Width, &haloRecvDispls[k][n]);
+        }
     }
-    else
+
+#if MPI_VERSION >= 4
+    for(int k = 0; k < sets; k++)
+        MPI_Neighbor_alltoallw_init(MPI_BOTTOM, haloCounts, haloSendDispls[k], haloTypes, MPI_BOTTOM, haloCounts, haloRecvDispls[k], haloTypes, haloComm, MPI_INFO_NULL, &haloPersistentRequests[k]);
+#endif
+}
+
+/* Whether the edge we send in some direction has changed since it was last sent, keeping a copy of it if it has */
+bool edgeHasChanged(int direction)
+{
+    int x;
+    int y;
+    int width;
+    int height;
+    bool changed;
+    char *copy;
+
+    edgeRegion(direction, false, &x, &y, &width, &height);
+
+    if(engine == PACKED_ENGINE)
     {
-        MPI_Barrier(MPI_COMM_WORLD); //If we are a slave, barrier until the master is done
+        //Packed edges were just packed into their staging buffer
+        changed = !haloPrimed || memcmp(sendEdges[direction], lastEdges[direction], sizeof(uint64_t) * packedEdgeWords(width, height)) != 0;
+
+        if(changed)
+            memcpy(lastEdges[direction], sendEdges[direction], sizeof(uint64_t) * packedEdgeWords(width, height));
+
+        return changed;
     }
 
+    copy = lastEdges[direction];
+    changed = !haloPrimed;
 
-    MPI_Finalize();//Godbye world!
+    for(int k = 0; k < height && !changed; k++)
+        changed = memcmp(copy + k * width, localBoard + x + (y + k) * localBoard_Width, width) != 0;
+
+    if(changed)
+        for(int k = 0; k < height; k++)
+            memcpy(copy + k * width, localBoard + x + (y + k) * localBoard_Width, width);
+
+    return changed;
 }
 
-/* Initializes the board and commucates the important parts to slaves */
-void initializeBoard(int argc, char ** argv)
+#ifdef GOL_TIMING
+/* Bytes in the edge sent to haloComm neighbor n */
+long long haloMessageBytes(int n)
 {
-    int * curLoopNeighbors;
-    int curLoopBoard_Size;
-    char * curLoopBoard;
-    int l;
-    int numberOfProcessors;
-
-    parseFile(argc, argv);
+    int size;
 
-    partitionArray = generateBoard(masterBoard_columns, masterBoard_rows, &actualPartitions); //Parse the file
+    MPI_Type_size(haloTypes[n], &size);
 
-    MPI_Comm_size(MPI_COMM_WORLD, &numberOfProcessors);
+    return (long long)size * haloCounts[n];
+}
+#endif
 
-    printf("Forcing %d partitions\n", actualPartitions);
+/* Tells each neighbor on our node which buffer our board is in, now that it's ready to be read */
+void startSharedExchange()
+{
+    if(numberOfSharedNeighbors == 0)
+        return;
 
-    numberOfMemoryAllocations = actualPartitions;
-    allocatedMemory = malloc(sizeof(char*) * (numberOfMemoryAllocations + 8));
+    //Everything written to our board has to be visible to the neighbors before they're told they can read it
+    MPI_Win_sync(boardWindow);
 
-    for(int i = 0; i < actualPartitions; i++)
+    for(int s = 0; s < numberOfSharedNeighbors; s++)
     {
-        curLoopNeighbors = neighborList(i);//Find the neighbors of the tile
-        MPI_Isend(&partitionArray[i], sizeof(struct partition), MPI_BYTE, i, BOUNDS_MESSAGE, MPI_COMM_WORLD, &lastRequest); //Send the structure containing their coords
-        MPI_Isend(curLoopNeighbors, 8, MPI_INT, i, NEIGHBORLIST_MESSAGE, MPI_COMM_WORLD, &lastRequest); //Send them their neighbor list so the slave knows who to contact
+        int rank = sharedRanks[sharedNeighbors[s]];
+
+        MPI_Irecv(&sharedReadyBoards[sharedNeighbors[s]], 1, MPI_INT, rank, SHARED_READY_TAG, nodeComm, &sharedReadyRequests[2 * s]);
+        MPI_Isend(&currentBoard, 1, MPI_INT, rank, SHARED_READY_TAG, nodeComm, &sharedReadyRequests[2 * s + 1]);
+        MPI_Irecv(NULL, 0, MPI_BYTE, rank, SHARED_DONE_TAG, nodeComm, &sharedDoneRequests[2 * s]);
+
+        TIMING_SIGNAL(neighborDirections[sharedNeighbors[s]]);
+    }
+}
 
-        curLoopBoard_Size = (partitionArray[i].lengthX+2)*(partitionArray[i].lengthY+2);
-        curLoopBoard = malloc(sizeof(char) *curLoopBoard_Size);
+/* Copies the edge of each neighbor on our node straight out of its board into our ghost region, as soon as it says its board is
+   ready, and tells it once we're done. Packed edges go through the staging buffer they'd have arrived in */
+void finishSharedExchange()
+{
+    int x;
+    int y;
+    int width;
+    int height;
+    int ghostX;
+    int ghostY;
+
+    if(numberOfSharedNeighbors == 0)
+        return;
 
-        l = 0;//position in the board to be sent to clients
+    MPI_Waitall(2 * numberOfSharedNeighbors, sharedReadyRequests, MPI_STATUSES_IGNORE);
 
-	//Build the slave board from the relevant positions in the master board
-        for(int k = partitionArray[i].startY - 1; k <= (partitionArray[i].startY + partitionArray[i].lengthY); k++)
+    //And whatever they wrote before saying so has to be visible to us
+    MPI_Win_sync(boardWindow);
+
+    for(int s = 0; s < numberOfSharedNeighbors; s++)
+    {
+        int n = sharedNeighbors[s];
+        int j = neighborDirections[n];
+        int neighborWidth = sharedPartitions[n].lengthX + 2 * haloDepth;
+        char *board = sharedBoards[n] + sharedReadyBoards[n] * sharedBoardBytes[n];
+
+        //An edge that didn't change is put back from the copy kept of it, the same as one that wasn't sent.
+        //Our ghost region in some direction is the neighbor's edge facing back the other way
+        if(tileSize == 0 || ghostChanged[n])
         {
-            for(int j = partitionArray[i].startX - 1; j <= (partitionArray[i].startX + partitionArray[i].lengthX); j++)
+            partitionEdgeRegion(&sharedPartitions[n], 7 - j, false, &x, &y, &width, &height);
+
+            if(engine == PACKED_ENGINE)
             {
-                if((k < 0) || (j < 0) || (k >= masterBoard_rows) || (j >= masterBoard_columns))
-                    curLoopBoard[l++] = 0;
-                else
-                    curLoopBoard[l++] = masterBoard[j + (k * masterBoard_columns)];
+                packRegion((uint64_t *)board, packedRowWords(neighborWidth), x, y, width, height, recvEdges[j]);
+                TIMING_SHARED_COPY(7 - j, (long long)sizeof(uint64_t) * packedEdgeWords(width, height));
             }
-        }
+            else
+            {
+                edgeRegion(j, true, &ghostX, &ghostY, &width, &height);
+
+                for(int k = 0; k < height; k++)
+                    memcpy(localBoard + ghostX + (ghostY + k) * localBoard_Width, board + x + (long)(y + k) * neighborWidth, width);
 
-        allocatedMemory[i] = curLoopBoard;
+                TIMING_SHARED_COPY(7 - j, (long long)width * height);
+            }
+        }
 
-        MPI_Isend(curLoopBoard, curLoopBoard_Size, MPI_CHAR, i, BOARD_MESSAGE, MPI_COMM_WORLD, &lastRequest);//Send the board
+        MPI_Isend(NULL, 0, MPI_BYTE, sharedRanks[n], SHARED_DONE_TAG, nodeComm, &sharedDoneRequests[2 * s + 1]);
+        TIMING_SIGNAL(j);
     }
 
-    printf("\nInitial board: \n");
+    sharedReadsPending = true;
+}
 
-    for(int i = 0; i < masterBoard_columns * masterBoard_rows; i++)
-    {
-        if(masterBoard[i] == 1)
-            printf("*");
-        else
-            printf(".");
-        if((i + 1) % (masterBoard_columns) == 0)
-            printf("\n");
-    }
+/* Waits for the neighbors on our node to finish reading the board we last exchanged. It has to be done before that buffer is
+   written again, which is as soon as it becomes nextGenBoard */
+void finishSharedReads()
+{
+    if(!sharedReadsPending)
+        return;
 
-    //Send EVERYONE, even those with no work, the number of generations and processors so the barriers work
-    for(int i = 0; i < numberOfProcessors; i++)
-        MPI_Isend(&actualPartitions, 1, MPI_INT, i, PARTITION_MESSAGE, MPI_COMM_WORLD, &lastRequest);
+    MPI_Waitall(2 * numberOfSharedNeighbors, sharedDoneRequests, MPI_STATUSES_IGNORE);
 
-    for(int i = 0; i < numberOfProcessors; i++)
-        MPI_Isend(&numberOfGenerations, 1, MPI_INT, i, GENERATION_MESSAGE, MPI_COMM_WORLD ,&lastRequest);
+    sharedReadsPending = false;
 }
 
-/* Updates the board */
-void calculateBoard()
+/* Starts swapping edges with every neighbor. Ghost cells can't be used until finishHaloExchange().
+   With active tiles the neighbors first tell each other which edges changed, then only those are sent */
+void startHaloExchange()
 {
-    char *memoryArray[8];
-    int memoryUsed;
+    int x;
+    int y;
+    int width;
+    int height;
+    int set;
+    int sendCounts[8];
+    int recvCounts[8];
 
-    char * sendEdge;
-    int sendSize;
-    int recvSize;
-    int tag;
+    TIMING_START(TIMING_EXCHANGE);
 
-    char * recvEdge;
-    int currentNeighbor;
+    set = (engine == PACKED_ENGINE) ? 0 : currentBoard;
 
-    while(numberOfGenerations-- > 0)
+    if(engine == PACKED_ENGINE)
     {
-        memoryUsed = 0;
-
-        /* Send */
-        if(identity < actualPartitions)//If we are a board doing work
+        //Neighbors on our node read our board themselves, their edges are only packed to see if they changed
+        for(int n = 0; n < numberOfNeighbors; n++)
         {
-            for(int j = 0; j < 8; j++)
-            {
-                if(myNeighborIDs[j] > -1)
-                {
-		    //Do the calculations to find out what cells need to be transported to the neighbors
-                    switch(j)
-                    {
-                    case 0://For Example
-                        sendEdge = malloc(sizeof(char) * 1);
-                        sendEdge[0] = localBoard[myCoords.lengthX + 3];//The NW cell in my array should be located from the over provisioned region
-                        sendSize = 1;//It is of size one
-                        tag = SE_UPDATE;//This is a SE update from my neighbor's perspective
-                        break;
-                    case 1:
-                        sendEdge = malloc(sizeof(char) * myCoords.lengthX);
-                        for(int k = 0; k < myCoords.lengthX; k++)
-                            sendEdge[k] = localBoard[myCoords.lengthX + 3 + k];
-                        sendSize = myCoords.lengthX;
-                        tag = S_UPDATE;
-                        break;
-                    case 2:
-                        sendEdge = malloc(sizeof(char) * 1);
-                        sendEdge[0] = localBoard[myCoords.lengthX + 2 + myCoords.lengthX];
-                        sendSize = 1;
-                        tag = SW_UPDATE;
-                        break;
-                    case 3:
-                        sendEdge = malloc(sizeof(char) * myCoords.lengthY);
-                        for(int k = 0; k < myCoords.lengthY; k++)
-                            sendEdge[k] = localBoard[(myCoords.lengthX + 3) + k * (myCoords.lengthX + 2)];
-                        sendSize = myCoords.lengthY;
-                        tag = E_UPDATE;
-                        break;
-                    case 4:
-                        sendEdge = malloc(sizeof(char) * myCoords.lengthY);
-                        for(int k = 0; k < myCoords.lengthY; k++)
-                            sendEdge[k] = localBoard[(myCoords.lengthX + 2 + myCoords.lengthX) + k * (myCoords.lengthX + 2)];
-                        sendSize = myCoords.lengthY;
-                        tag = W_UPDATE;
-                        break;
-                    case 5:
-                        sendEdge = malloc(sizeof(char) * 1);
-                        sendEdge[0] = localBoard[((myCoords.lengthX + 2) * myCoords.lengthY) + 1];
-                        sendSize = 1;
-                        tag = NE_UPDATE;
-                        break;
-                    case 6:
-                        sendEdge = malloc(sizeof(char) * myCoords.lengthX);
-                        for(int k = 0; k < myCoords.lengthX; k++)
-                            sendEdge[k] = localBoard[(myCoords.lengthX + 2) * myCoords.lengthY + 1 + k];
-                        sendSize = myCoords.lengthX;
-                        tag = N_UPDATE;
-                        break;
-                    case 7:
-                        sendEdge = malloc(sizeof(char) * 1);
-                        sendEdge[0] = localBoard[(myCoords.lengthX + 2) * myCoords.lengthY + myCoords.lengthX];
-                        sendSize = 1;
-                        tag = NW_UPDATE;
-                        break;
-                    }
-
-                    memoryArray[memoryUsed++] = sendEdge;
-
-                    MPI_Isend(sendEdge, sendSize, MPI_CHAR, myNeighborIDs[j], tag, MPI_COMM_WORLD, &lastRequest);//Send data
-                }
-            }
+            if(sharedRanks[n] != MPI_UNDEFINED && tileSize == 0)
+                continue;
 
-            /* Receive */
-            for(int j = 0; j < 8; j++)
-            {
-                currentNeighbor = myNeighborIDs[j];
+            edgeRegion(neighborDirections[n], false, &x, &y, &width, &height);
+            packRegion(localPackedBoard, localBoard_RowWords, x, y, width, height, sendEdges[neighborDirections[n]]);
+        }
+    }
 
-                //Sets up the buffers and information that is going to be received in a similar way but in the oppotite direction
-                if(currentNeighbor > -1)
-                {
-                    switch(j)
-                    {
-                    case 0:
-                        recvEdge = malloc(sizeof(char) * 1);
-                        recvSize = 1;
-                        tag = NW_UPDATE;
-                        break;
-                    case 1:
-                        recvEdge = malloc(sizeof(char) * myCoords.lengthX);
-                        recvSize = myCoords.lengthX;
-                        tag = N_UPDATE;
-                        break;
-                    case 2:
-                        recvEdge = malloc(sizeof(char) * 1);
-                        recvSize = 1;
-                        tag = NE_UPDATE;
-                        break;
-                    case 3:
-                        recvEdge = malloc(sizeof(char) * myCoords.lengthY);
-                        recvSize = myCoords.lengthY;
-                        tag = W_UPDATE;
-                        break;
-                    case 4:
-                        recvEdge = malloc(sizeof(char) * myCoords.lengthY);
-                        recvSize = myCoords.lengthY;
-                        tag = E_UPDATE;
-                        break;
-                    case 5:
-                        recvEdge = malloc(sizeof(char) * 1);
-                        recvSize = 1;
-                        tag = SW_UPDATE;
-                        break;
-                    case 6:
-                        recvEdge = malloc(sizeof(char) * myCoords.lengthX);
-                        recvSize = myCoords.lengthX;
-                        tag = S_UPDATE;
-                        break;
-                    case 7:
-                        recvEdge = malloc(sizeof(char) * 1);
-                        recvSize = 1;
-                        tag = SE_UPDATE;
-                        break;
-                    }
-
-                    MPI_Recv(recvEdge, recvSize, MPI_CHAR, currentNeighbor, tag, MPI_COMM_WORLD, &lastStatus);//Sync recv
-
-                    //Figures out what to do with the information
-                    switch(tag)
-                    {
-                    case NW_UPDATE:
-                        localBoard[0] = recvEdge[0];
-                        break;
-                    case N_UPDATE:
-                        for(int i = 0; i < myCoords.lengthX; i++)
-                            localBoard[1 + i] = recvEdge[i];
-                        break;
-                    case NE_UPDATE:
-                        localBoard[myCoords.lengthX + 1] = recvEdge[0];
-                        break;
-                    case W_UPDATE:
-                        for(int i = 0; i < myCoords.lengthY; i++)
-                            localBoard[myCoords.lengthX + 2 + (i * (myCoords.lengthX + 2))] = recvEdge[i];
-                        break;
-                    case E_UPDATE:
-                        for(int i = 0; i < myCoords.lengthY; i++)
-                            localBoard[myCoords.lengthX + 3 + myCoords.lengthX + (i * (myCoords.lengthX + 2))] = recvEdge[i];
-                        break;
-                    case SW_UPDATE:
-                        localBoard[(myCoords.lengthX + 2) * (myCoords.lengthY + 1)] = recvEdge[0];
-                        break;
-                    case S_UPDATE:
-                        for(int i = 0; i < myCoords.lengthX; i++)
-                            localBoard[(myCoords.lengthX + 2) * (myCoords.lengthY + 1) + 1 + i] = recvEdge[i];
-                        break;
-                    case SE_UPDATE:
-                        localBoard[(myCoords.lengthX + 2) * (myCoords.lengthY + 2) - 1] = recvEdge[0];
-                        break;
-                    }
-
-                    free(recvEdge);
-                }
-            }
+    startSharedExchange();
 
-            /* Does actual liveliness calculations */
-            for(int j = 0; j < (myCoords.lengthY + 2); j++)
-            {
-                for(int i = 0; i < (myCoords.lengthX + 2); i++)
-                {
-                    if(isAlive(i, j))
-                        setNextArray(i, j, 1);
-                    else
-                        setNextArray(i, j, 0);
-                }
-            }
+    if(tileSize > 0)
+    {
+        for(int n = 0; n < numberOfNeighbors; n++)
+            edgeChanged[n] = edgeHasChanged(neighborDirections[n]);
 
-            swapBoards();
+        MPI_Neighbor_alltoall(edgeChanged, 1, MPI_INT, ghostChanged, 1, MPI_INT, haloComm);
 
-            for(int i = 0; i < memoryUsed; i++)
-                free(memoryArray[i]);
-        }
+        haloPrimed = true;
 
+        for(int n = 0; n < numberOfNeighbors; n++)
+        {
+            sendCounts[n] = edgeChanged[n] ? haloCounts[n] : 0;
+            recvCounts[n] = ghostChanged[n] ? haloCounts[n] : 0;
+
+            if(edgeChanged[n] && haloCounts[n] > 0)
+                TIMING_MESSAGE(neighborDirections[n], haloMessageBytes(n));
+        }
 
+        MPI_Ineighbor_alltoallw(MPI_BOTTOM, sendCounts, haloSendDispls[set], haloTypes, MPI_BOTTOM, recvCounts, haloRecvDispls[set], haloTypes, haloComm, &haloRequest);
 
-        MPI_Barrier(MPI_COMM_WORLD);   //Once done, chill out till everyon else is done.
+        TIMING_STOP(TIMING_EXCHANGE);
+        return;
     }
 
-    MPI_Barrier(MPI_COMM_WORLD); //Wait here after all generations are done
+#if MPI_VERSION >= 4
+    haloRequest = haloPersistentRequests[set];
+    MPI_Start(&haloRequest);
+#else
+    MPI_Ineighbor_alltoallw(MPI_BOTTOM, haloCounts, haloSendDispls[set], haloTypes, MPI_BOTTOM, haloCounts, haloRecvDispls[set], haloTypes, haloComm, &haloRequest);
+#endif
 
-    if(identity < actualPartitions)
-        MPI_Isend(localBoard, (myCoords.lengthX + 2) * (myCoords.lengthY + 2), MPI_CHAR, 0, BOARD_MESSAGE, MPI_COMM_WORLD, &lastRequest); //send the board back to the master
+    for(int n = 0; n < numberOfNeighbors; n++)
+        if(haloCounts[n] > 0)
+            TIMING_MESSAGE(neighborDirections[n], haloMessageBytes(n));
 
-    MPI_Barrier(MPI_COMM_WORLD); //wait here until everybody sends their data
+    TIMING_STOP(TIMING_EXCHANGE);
 }
 
-/* Determines if some cell is alive or dead in the next board generation */
-bool isAlive(int x, int y)
+/* Waits for every edge to arrive and lands them in the ghost ring */
+void finishHaloExchange()
 {
-    bool alive;
-    int numNeighbors;
+    int x;
+    int y;
+    int width;
+    int height;
 
-    alive = false;
+    TIMING_START(TIMING_WAIT);
 
-    numNeighbors = 0;
+    MPI_Wait(&haloRequest, MPI_STATUS_IGNORE);
 
-    for(int j = -1; j <= 1; j++)
-        for(int i = -1; i <= 1; i++)
+    finishSharedExchange();
+
+    if(engine == PACKED_ENGINE)
+    {
+        //An edge that didn't change was never sent, so its staging buffer still holds it from last time
+        for(int n = 0; n < numberOfNeighbors; n++)
         {
-            if(!(((x + i) < 0) || ((x + i) >= (myCoords.lengthX + 2)) || ((y + j) < 0) || ((y + j) >= (myCoords.lengthY + 2)) || (i == 0 && j == 0)))//If the cell is in-bounds
-                numNeighbors += getArray(x + i, y + j);
+            edgeRegion(neighborDirections[n], true, &x, &y, &width, &height);
+            unpackRegion(localPackedBoard, localBoard_RowWords, x, y, width, height, recvEdges[neighborDirections[n]]);
         }
+    }
+
+    if(tileSize == 0)
+    {
+        TIMING_STOP(TIMING_WAIT);
+        return;
+    }
 
-    //Only two cases in which a cell will live
-    if((getArray(x,y) == 1) && (numNeighbors == 2 || numNeighbors == 3))
-        alive = true;
-    else if((getArray(x,y) == 0) && (numNeighbors == 3))
-        alive = true;
+    for(int n = 0; n < numberOfNeighbors; n++)
+    {
+        int j = neighborDirections[n];
 
-    return alive;
-}
+        edgeRegion(j, true, &x, &y, &width, &height);
 
-//Swaps the current gen board with the next gen board to save from mallocing tons of boards
-void swapBoards(void)
-{
-    char* tempBoard;
+        if(ghostChanged[n])
+            markTiles(x, y, width, height);
 
-    tempBoard = localBoard;
-    localBoard = nextGenBoard;
-    nextGenBoard = tempBoard;
+        if(engine == PACKED_ENGINE)
+            continue;
+
+        //Char boards have their ghost cells overwritten by the generations in between, so they're put back from the copy
+        for(int k = 0; k < height; k++)
+        {
+            if(ghostChanged[n])
+                memcpy(lastGhosts[j] + k * width, localBoard + x + (y + k) * localBoard_Width, width);
+            else
+                memcpy(localBoard + x + (y + k) * localBoard_Width, lastGhosts[j] + k * width, width);
+        }
+    }
+
+    TIMING_STOP(TIMING_WAIT);
 }
 
-void initMPI(int argc, char ** argv)
+/* Releases everything setupHaloExchange() built */
+void freeHaloExchange()
 {
-    MPI_Init(&argc, &argv);
-    MPI_Comm_rank(MPI_COMM_WORLD, &identity);
+    finishSharedReads();
 
-    numberOfMemoryAllocations = 0;//Used for our garbage collection stuff
+#if MPI_VERSION >= 4
+    for(int k = 0; k < (engine == PACKED_ENGINE ? 1 : 2); k++)
+        MPI_Request_free(&haloPersistentRequests[k]);
+#endif
 
-    if(!identity)//If we are the master
+    for(int n = 0; n < numberOfNeighbors; n++)
     {
-        MPI_Comm_size(MPI_COMM_WORLD, &actualPartitions);
-        initializeBoard(argc, argv);
+        int j = neighborDirections[n];
+
+        if(engine == PACKED_ENGINE)
+        {
+            free(sendEdges[j]);
+            free(recvEdges[j]);
+        }
+        else
+        {
+            MPI_Type_free(&edgeTypes[j]);
+
+            if(tileSize > 0)
+                free(lastGhosts[j]);
+        }
+
+        if(tileSize > 0)
+            free(lastEdges[j]);
     }
-    else
-        allocatedMemory = malloc(sizeof(char*) * 8);
 
-    MPI_Barrier(MPI_COMM_WORLD);//Wait here for eveybody (specifically the master)
+    MPI_Comm_free(&haloComm);
+}
+
+/* Lays the working ranks out in a Cartesian grid the same shape as the partitions and finds our partition and neighbors in it.
+   MPI is allowed to reorder ranks, so our partition comes from where we ended up in the grid rather than from our rank */
+void createTopology()
+{
+    int dimensions[2];
+    int periods[2] = {0, 0};
+    int coords[2];
+    int neighborCoords[2];
+    int cartRank;
+    int nodeRanks;
+    int dx;
+    int dy;
+
+    dimensions[0] = partitionsY;//Rows first, then columns
+    dimensions[1] = partitionsX;
 
-    MPI_Recv(&actualPartitions, 1, MPI_INT, 0, PARTITION_MESSAGE, MPI_COMM_WORLD, &lastStatus);//Get the previously send data about the number of partitions and generations
+    //The first ranks take the partitions, which keeps the master among them
+    MPI_Comm_split(MPI_COMM_WORLD, identity < actualPartitions ? 0 : MPI_UNDEFINED, identity, &boardComm);
 
-    MPI_Recv(&numberOfGenerations, 1, MPI_INT, 0, GENERATION_MESSAGE, MPI_COMM_WORLD, &lastStatus);
+    hasPartition = (boardComm != MPI_COMM_NULL);
+    myPartition = -1;
+    cartComm = MPI_COMM_NULL;
+    nodeComm = MPI_COMM_NULL;
 
-    if(identity < actualPartitions)//If we are a process with work to do
+    if(!hasPartition)
+        return;
+
+    MPI_Cart_create(boardComm, 2, dimensions, periods, 1, &cartComm);
+
+    MPI_Comm_rank(cartComm, &cartRank);
+    MPI_Cart_coords(cartComm, cartRank, 2, coords);
+
+    myPartition = coords[0] * dimensions[1] + coords[1];
+    myCoords = partitionArray[myPartition];
+
+    for(int j = 0; j < 8; j++)
     {
-        MPI_Recv(&myCoords, sizeof(struct partition), MPI_BYTE, 0, BOUNDS_MESSAGE, MPI_COMM_WORLD, &lastStatus);//Recv the info we will need to do the work
-        MPI_Recv(myNeighborIDs, 8, MPI_INT, 0, NEIGHBORLIST_MESSAGE, MPI_COMM_WORLD, &lastStatus);
-        localBoard_Size = (myCoords.lengthX + 2) * (myCoords.lengthY + 2);
-        localBoard = malloc(sizeof(char) * localBoard_Size);
-        MPI_Recv(localBoard, localBoard_Size, MPI_CHAR, 0, BOARD_MESSAGE,MPI_COMM_WORLD, &lastStatus);
-        nextGenBoard = malloc(sizeof(char) * localBoard_Size);
+        directionOffset(j, &dx, &dy);
+        neighborCoords[0] = coords[0] + dy;
+        neighborCoords[1] = coords[1] + dx;
 
+        if(neighborCoords[0] < 0 || neighborCoords[0] >= dimensions[0] || neighborCoords[1] < 0 || neighborCoords[1] >= dimensions[1])
+            myNeighborIDs[j] = -1;
+        else
+            MPI_Cart_rank(cartComm, neighborCoords, &myNeighborIDs[j]);
+    }
+
+    //The ranks on each node share their boards, unless they're the only one on it
+    if(sharedHalo)
+    {
+        MPI_Comm_split_type(cartComm, MPI_COMM_TYPE_SHARED, 0, MPI_INFO_NULL, &nodeComm);
+        MPI_Comm_size(nodeComm, &nodeRanks);
+
+        if(nodeRanks == 1)
+            MPI_Comm_free(&nodeComm);
     }
-    //Non-working processes do nothing.
 }
 
-void main(int argc, char ** argv)
+/* Prints how the program is meant to be run */
+void printUsage(const char *program)
 {
-    initMPI(argc, argv);
+    printf("Usage: %s [-engine cell|packed|simd|lookup|hashlife] [-rule rulestring] [-isa scalar|sse2|avx2|avx512] [-halo depth] [-threads count]\n", program);
+    printf("          [-tiles size [-temporal]] [-noshared] [-balance generations] [-memory megabytes] [-cycles window [-cycleEvery generations]] [-stats file [-statsEvery generations]] [-quiet] [-trace file] [-output file] [-checkpoint file [-every generations | -seconds seconds]]\n");
+    printf("          boardFile | -random columns rows density seed generations | -restart checkpointFile\n");
+}
+
+/* Reads the command line. Usage is [-engine cell|packed|simd|lookup|hashlife] [-rule rulestring] [-isa scalar|sse2|avx2|avx512] [-halo depth] [-threads count]
+   [-tiles size [-temporal]] [-noshared] [-balance generations] [-memory megabytes] [-cycles window [-cycleEvery generations]] [-stats file [-statsEvery generations]] [-quiet] [-trace file] [-output file] [-checkpoint file [-every generations | -seconds seconds]]
+   boardFile | -random columns rows density seed generations | -restart checkpointFile */
+void parseOptions(int argc, char ** argv)
+{
+    char *unknownOption;
+
+    unknownOption = NULL;
+    engine = CELL_ENGINE;
+    maximumISA = AVX512_ISA;
+    ruleText = NULL;
+    haloGenerations = 1;
+    threadsPerRank = 0;
+    hashlifeMegabytes = 1024;
+    tileSize = 0;   //Tiles add a round of flags to every exchange, so they're only worth it on boards that are mostly still
+    temporalBlocking = false;
+    sharedHalo = true;
+    balanceGenerations = 0;
+    boardFileName = NULL;
+    randomBoard = false;
+    outputFileName = NULL;
+    quiet = false;
+    traceFileName = NULL;
+    checkpointFileName = NULL;
+    restartFileName = NULL;
+    checkpointGenerations = 0;
+    checkpointSeconds = 0;
+    cycleWindow = 0;
+    cycleGenerations = 1;
+    statsFileName = NULL;
+    statsGenerations = 1;
+
+    for(int i = 1; i < argc; i++)
+    {
+        if(strcmp(argv[i], "-engine") == 0 && i + 1 < argc)
+        {
+            i++;
+
+            if(strcmp(argv[i], "cell") == 0)
+                engine = CELL_ENGINE;
+            else if(strcmp(argv[i], "packed") == 0)
+                engine = PACKED_ENGINE;
+            else if(strcmp(argv[i], "simd") == 0)
+                engine = SIMD_ENGINE;
+            else if(strcmp(argv[i], "lookup") == 0)
+                engine = LOOKUP_ENGINE;
+            else if(strcmp(argv[i], "hashlife") == 0)
+                engine = HASHLIFE_ENGINE;
+            else
+            {
+                printf("Unknown engine %s, expected cell, packed, simd, lookup or hashlife\n", argv[i]);
+                exit(1);
+            }
+        }
+        else if(strcmp(argv[i], "-rule") == 0 && i + 1 < argc)
+            ruleText = argv[++i];
+        else if(strcmp(argv[i], "-halo") == 0 && i + 1 < argc)
+        {
+            haloGenerations = atoi(argv[++i]);
+
+            if(haloGenerations < 1)
+            {
+                printf("The halo has to be at least 1 deep\n");
+                exit(1);
+            }
+        }
+        else if(strcmp(argv[i], "-random") == 0 && i + 5 < argc)
+        {
+            randomBoard = true;
+            masterBoard_columns = atoi(argv[++i]);
+            masterBoard_rows = atoi(argv[++i]);
+            randomDensity = atof(argv[++i]);
+            randomSeed = strtoull(argv[++i], NULL, 10);
+            numberOfGenerations = atoi(argv[++i]);
+
+            if(masterBoard_columns < 1 || masterBoard_rows < 1 || numberOfGenerations < 0 || randomDensity < 0 || randomDensity > 1)
+            {
+                printf("A random board needs at least one column and row, no fewer than 0 generations and a density from 0 to 1\n");
+                exit(1);
+            }
+        }
+        else if(strcmp(argv[i], "-output") == 0 && i + 1 < argc)
+            outputFileName = argv[++i];
+        else if(strcmp(argv[i], "-checkpoint") == 0 && i + 1 < argc)
+            checkpointFileName = argv[++i];
+        else if(strcmp(argv[i], "-every") == 0 && i + 1 < argc)
+        {
+            checkpointGenerations = atoi(argv[++i]);
+
+            if(checkpointGenerations < 1)
+            {
+                printf("Checkpoints can't be taken less than a generation apart\n");
+                printUsage(argv[0]);
+                exit(1);
+            }
+        }
+        else if(strcmp(argv[i], "-seconds") == 0 && i + 1 < argc)
+        {
+            checkpointSeconds = atof(argv[++i]);
+
+            if(checkpointSeconds <= 0)
+            {
+                printf("Checkpoints have to be some time apart\n");
+                printUsage(argv[0]);
+                exit(1);
+            }
+        }
+        else if(strcmp(argv[i], "-restart") == 0 && i + 1 < argc)
+            restartFileName = argv[++i];
+        else if(strcmp(argv[i], "-threads") == 0 && i + 1 < argc)
+        {
+            threadsPerRank = atoi(argv[++i]);
+
+            //Leaving it to OpenMP is done by not giving -threads at all
+            if(threadsPerRank < 1)
+            {
+                printf("Each rank needs at least one thread\n");
+                printUsage(argv[0]);
+                exit(1);
+            }
+        }
+        else if(strcmp(argv[i], "-tiles") == 0 && i + 1 < argc)
+        {
+            tileSize = atoi(argv[++i]);
+
+            if(tileSize < 0)
+            {
+                printf("Tiles can't be smaller than nothing, use 0 to turn them off\n");
+                exit(1);
+            }
+        }
+        else if(strcmp(argv[i], "-cycles") == 0 && i + 1 < argc)
+        {
+            cycleWindow = atoi(argv[++i]);
+
+            if(cycleWindow < 1)
+            {
+                printf("Looking for cycles needs at least one hash to compare with\n");
+                printUsage(argv[0]);
+                exit(1);
+            }
+        }
+        else if(strcmp(argv[i], "-cycleEvery") == 0 && i + 1 < argc)
+        {
+            cycleGenerations = atoi(argv[++i]);
+
+            if(cycleGenerations < 1)
+            {
+                printf("The board can't be hashed less than a generation apart\n");
+                printUsage(argv[0]);
+                exit(1);
+            }
+        }
+        else if(strcmp(argv[i], "-stats") == 0 && i + 1 < argc)
+            statsFileName = argv[++i];
+        else if(strcmp(argv[i], "-statsEvery") == 0 && i + 1 < argc)
+        {
+            statsGenerations = atoi(argv[++i]);
+
+            if(statsGenerations < 1)
+            {
+                printf("Statistics can't be taken less than a generation apart\n");
+                exit(1);
+            }
+        }
+        else if(strcmp(argv[i], "-quiet") == 0)
+            quiet = true;
+        else if(strcmp(argv[i], "-trace") == 0 && i + 1 < argc)
+            traceFileName = argv[++i];
+        else if(strcmp(argv[i], "-temporal") == 0)
+            temporalBlocking = true;
+        else if(strcmp(argv[i], "-noshared") == 0)
+            sharedHalo = false;
+        else if(strcmp(argv[i], "-balance") == 0 && i + 1 < argc)
+        {
+            balanceGenerations = atoi(argv[++i]);
+
+            if(balanceGenerations < 1)
+            {
+                printf("Rebalancing can't be considered less than a generation apart\n");
+                printUsage(argv[0]);
+                exit(1);
+            }
+        }
+        else if(strcmp(argv[i], "-memory") == 0 && i + 1 < argc)
+        {
+            hashlifeMegabytes = atoi(argv[++i]);
 
-    calculateBoard();
+            if(hashlifeMegabytes < 1)
+            {
+                printf("The hashlife engine needs at least 1 megabyte\n");
+                exit(1);
+            }
+        }
+        else if(strcmp(argv[i], "-isa") == 0 && i + 1 < argc)
+        {
+            i++;
 
-    finalizeBoard();
+            //Caps the instruction set the simd engine may use, handy for comparing them
+            for(maximumISA = AVX512_ISA; maximumISA > SCALAR_ISA; maximumISA--)
+                if(strcmp(argv[i], simdISAName(maximumISA)) == 0)
+                    break;
 
+            if(strcmp(argv[i], simdISAName(maximumISA)) != 0)
+            {
+                printf("Unknown instruction set %s, expected scalar, sse2, avx2 or avx512\n", argv[i]);
+                exit(1);
+            }
+        }
+        else if(argv[i][0] == '-')
+        {
+            //A mistyped option would otherwise be taken for the board file
+            unknownOption = argv[i];
+            break;
+        }
+        else
+            boardFileName = argv[i];
+    }
+
+    if(unknownOption != NULL || (boardFileName == NULL && !randomBoard && restartFileName == NULL))
+    {
+        if(unknownOption != NULL)
+            printf("Unknown option %s, or it's missing its value\n", unknownOption);
+
+        printUsage(argv[0]);
+        exit(1);
+    }
+
+#ifndef GOL_TIMING
+    if(traceFileName != NULL && !identity)
+        printf("Built without GOL_TIMING, so there's no trace to write\n");
+#endif
+
+    if(temporalBlocking && tileSize == 0)
+    {
+        printf("Temporal blocking works a tile at a time, so it needs -tiles\n");
+        exit(1);
+    }
+
+    //Checkpoints go by generations unless there's a time limit, 1000 apart if neither was given
+    if(checkpointGenerations == 0 && checkpointSeconds == 0)
+        checkpointGenerations = 1000;
+}
+
+/* Name of an engine as it's given to -engine */
+const char * engineName(engineType type)
+{
+    switch(type)
+    {
+    case PACKED_ENGINE:
+        return "packed";
+    case SIMD_ENGINE:
+        return "simd";
+    case LOOKUP_ENGINE:
+        return "lookup";
+    case HASHLIFE_ENGINE:
+        return "hashlife";
+    default:
+        return "cell";
+    }
+}
+
+/* Frees all known allocated memory */
+void freeMemory()
+{
+    for(int i = 0; i < numberOfMemoryAllocations; i++)
+        free(allocatedMemory[i]);
+}
+
+/* Number of threads each rank works with, 1 when built without OpenMP */
+int threadCount()
+{
+#ifdef _OPENMP
+    return omp_get_max_threads();
+#else
+    return 1;
+#endif
+}
+
+/* Finds the line and column of some position in a buffer holding the start of a file */
+void textPosition(const char *buffer, int position, int *line, int *column)
+{
+    int lineStart;
+
+    *line = 1;
+    lineStart = 0;
+
+    for(int i = 0; i < position; i++)
+        if(buffer[i] == '\n')
+        {
+            (*line)++;
+            lineStart = i + 1;
+        }
+
+    *column = position - lineStart + 1;
+}
+
+/* Reads the generations, columns, and rows at the start of a text board and the rule if there is one, then finds where the board starts
+   and how each row ends. Says exactly what's wrong and returns false if the file doesn't look right */
+bool parseTextHeader(char *buffer, int count, MPI_Offset fileSize)
+{
+    const char *fieldNames[3] = {"generations", "columns", "rows"};
+    int *fields[3] = {&numberOfGenerations, &masterBoard_columns, &masterBoard_rows};
+    int position;
+    int fieldEnd;
+    int line;
+    int column;
+    int endingLength;
+    long rowsInFile;
+    struct lifeRule fileRule;
+    MPI_Status status;
+
+    position = 0;
+
+    for(int i = 0; i < 3; i++)
+    {
+        if(sscanf(buffer + position, "%d%n", fields[i], &fieldEnd) != 1 || *fields[i] < (i ? 1 : 0))
+        {
+            //Skip what sscanf would have before saying where the number should be
+            while(position < count && isspace((unsigned char)buffer[position]))
+                position++;
+
+            textPosition(buffer, position, &line, &column);
+            printf("Your file specification's jacked up at line %d, column %d: expected the number of %s\n", line, column, fieldNames[i]);
+            return false;
+        }
+
+        position += fieldEnd;
+    }
+
+    while(position < count && isspace((unsigned char)buffer[position]))
+        position++;
+
+    //A line after the header that isn't a row of cells is the rule the board is for
+    if(position < count && buffer[position] != '*' && buffer[position] != '.')
+    {
+        for(fieldEnd = 0; position + fieldEnd < count && !isspace((unsigned char)buffer[position + fieldEnd]); fieldEnd++);
+
+        if(fieldEnd < (int)sizeof(boardRule))
+        {
+            memcpy(boardRule, buffer + position, fieldEnd);
+            boardRule[fieldEnd] = '\0';
+        }
+
+        if(fieldEnd >= (int)sizeof(boardRule) || !parseRule(boardRule, &fileRule))
+        {
+            textPosition(buffer, position, &line, &column);
+            printf("Your file specification's jacked up at line %d, column %d: expected a rule like B3/S23 or R2,C0,M1,S2..5,B4..5,NM, or the first row of the board\n", line, column);
+            return false;
+        }
+
+        position += fieldEnd;
+    }
+
+    //The board starts at the first cell after the header, with nothing but blank space in between
+    while(position < count && isspace((unsigned char)buffer[position]))
+        position++;
+
+    textPosition(buffer, position, &line, &column);
+
+    if(position == count || (buffer[position] != '*' && buffer[position] != '.'))
+    {
+        printTextBoardError(line, column, masterBoard_columns, position < count ? buffer[position] : EOF);
+        return false;
+    }
+
+    boardDataStart = position;
+    boardFirstLine = line;
+
+    //Whatever comes between the end of the first row and the first cell of the next is the line ending, and every row has the same one
+    MPI_File_read_at(boardFile, boardDataStart + masterBoard_columns, buffer, HEADER_BYTES, MPI_CHAR, &status);
+    MPI_Get_count(&status, MPI_CHAR, &count);
+
+    for(endingLength = 0; endingLength < count && buffer[endingLength] != '*' && buffer[endingLength] != '.'; endingLength++)
+        boardRowEnding[endingLength] = buffer[endingLength];
+
+    boardRowStride = masterBoard_columns + endingLength;
+
+    //Rows have to be on lines of their own, so the first row can't run on into the next
+    if(masterBoard_rows > 1 && (endingLength == HEADER_BYTES || !memchr(buffer, '\n', endingLength)))
+    {
+        printTextBoardError(boardFirstLine, masterBoard_columns + endingLength + 1, masterBoard_columns, endingLength < count ? buffer[endingLength] : EOF);
+        return false;
+    }
+
+    //Checks to see if the file is too short to hold every row
+    if(fileSize < boardDataStart + (MPI_Offset)(masterBoard_rows - 1) * boardRowStride + masterBoard_columns)
+    {
+        rowsInFile = (fileSize - boardDataStart) / boardRowStride;
+        printTextBoardError(boardFirstLine + rowsInFile, fileSize - boardDataStart - rowsInFile * boardRowStride + 1, masterBoard_columns, EOF);
+        return false;
+    }
+
+    return true;
+}
+
+/* Opens the board file on every rank and reads its header. Text boards have the format ITERATIONS COLUMNS ROWS, then optionally a rule (B3/S23 if not),
+   followed by the board, one row per line, so that every row starts the same number of bytes after the one before. Binary boards are described in BoardFile.h. Only the master reads the header,
+   everyone else gets it broadcast along with where the board starts and how far apart its rows are */
+void openBoardFile()
+{
+    long long header[8];
+    struct boardFileHeader binaryHeader;
+    char buffer[HEADER_BYTES + 1];
+    int count;
+    MPI_Offset fileSize;
+    MPI_Status status;
+
+    //Breaks if the user pointed to a file that doesn't exist
+    if(MPI_File_open(MPI_COMM_WORLD, boardFileName, MPI_MODE_RDONLY, MPI_INFO_NULL, &boardFile) != MPI_SUCCESS)
+    {
+        if(!identity)
+            printf("Could not find file! Please restart and retry.");
+        exit(1);
+    }
+
+    if(!identity)
+    {
+        header[0] = 0;//Whether the header made sense
+        boardFormat = TEXT_BOARD;
+        strcpy(boardRule, BOARD_FILE_RULE);
+
+        MPI_File_read_at(boardFile, 0, buffer, HEADER_BYTES, MPI_CHAR, &status);
+        MPI_Get_count(&status, MPI_CHAR, &count);
+        buffer[count] = '\0';
+
+        MPI_File_get_size(boardFile, &fileSize);
+
+        if(isBinaryBoard(buffer, count))
+        {
+            boardFormat = BINARY_BOARD;
+
+            if(readBoardFileHeader(buffer, count, &binaryHeader))
+            {
+                numberOfGenerations = binaryHeader.generations;
+                masterBoard_columns = binaryHeader.columns;
+                masterBoard_rows = binaryHeader.rows;
+                boardDataStart = binaryHeader.headerSize;
+                boardRowStride = binaryHeader.rowBytes;
+
+                header[0] = fileSize >= boardDataStart + (MPI_Offset)masterBoard_rows * boardRowStride;
+
+                strcpy(boardRule, binaryHeader.rule);
+            }
+        }
+        else
+            header[0] = parseTextHeader(buffer, count, fileSize);
+
+        header[1] = numberOfGenerations;
+        header[2] = masterBoard_columns;
+        header[3] = masterBoard_rows;
+        header[4] = boardDataStart;
+        header[5] = boardRowStride;
+        header[6] = boardFormat;
+        header[7] = boardFirstLine;
+    }
+
+    MPI_Bcast(header, 8, MPI_LONG_LONG, 0, MPI_COMM_WORLD);
+
+    //Text boards have already said what's wrong with them
+    if(!header[0])
+    {
+        if(!identity && header[6] == BINARY_BOARD)
+        {
+            if(isByteSwapped(buffer, count))
+                printf("%s was written on a machine with the other byte order\n", boardFileName);
+            else
+                printf("Your file specification's jacked up, might want to check it out.");
+        }
+        exit(1);
+    }
+
+    numberOfGenerations = header[1];
+    totalGenerations = numberOfGenerations;
+    masterBoard_columns = header[2];
+    masterBoard_rows = header[3];
+    boardDataStart = header[4];
+    boardRowStride = header[5];
+    boardFormat = header[6];
+    boardFirstLine = header[7];
+
+    MPI_Bcast(boardRule, sizeof(boardRule), MPI_CHAR, 0, MPI_COMM_WORLD);
+
+    if(boardFormat == TEXT_BOARD)
+        MPI_Bcast(boardRowEnding, HEADER_BYTES, MPI_CHAR, 0, MPI_COMM_WORLD);
+}
+
+/* Finds the latest complete checkpoint of the two written to restartFileName, opens it in place of a board file and reads its table of blocks */
+void openCheckpoint()
+{
+    long long header[7];
+    char fileName[FILENAME_MAX];
+    char buffer[sizeof(struct checkpointHeader)];
+    struct checkpointHeader checkpoint;
+    MPI_File candidate;
+    MPI_Status status;
+    int count;
+
+    if(!identity)
+    {
+        header[0] = -1;//Which of the two is the latest, if either is complete
+
+        for(int slot = 0; slot < 2; slot++)
+        {
+            snprintf(fileName, sizeof(fileName), "%s.%d", restartFileName, slot);
+
+            if(MPI_File_open(MPI_COMM_SELF, fileName, MPI_MODE_RDONLY, MPI_INFO_NULL, &candidate) != MPI_SUCCESS)
+                continue;
+
+            MPI_File_read_at(candidate, 0, buffer, sizeof(buffer), MPI_BYTE, &status);
+            MPI_Get_count(&status, MPI_BYTE, &count);
+            MPI_File_close(&candidate);
+
+            if(isByteSwapped(buffer, count))
+                printf("%s was written on a machine with the other byte order\n", fileName);
+
+            if(!readCheckpointHeader(buffer, count, &checkpoint) || (header[0] > -1 && checkpoint.generation <= header[2]))
+                continue;
+
+            strcpy(boardRule, checkpoint.rule);
+
+            header[0] = slot;
+            header[1] = checkpoint.blocks;
+            header[2] = checkpoint.generation;
+            header[3] = checkpoint.generations;
+            header[4] = checkpoint.columns;
+            header[5] = checkpoint.rows;
+        }
+
+        if(header[0] < 0)
+            printf("Couldn't find a complete checkpoint in %s.0 or %s.1\n", restartFileName, restartFileName);
+        else
+            printf("Restarting from generation %lld of %lld in %s.%lld\n", header[2], header[3], restartFileName, header[0]);
+    }
+
+    MPI_Bcast(header, 7, MPI_LONG_LONG, 0, MPI_COMM_WORLD);
+
+    if(header[0] < 0)
+        exit(1);
+
+    MPI_Bcast(boardRule, sizeof(boardRule), MPI_CHAR, 0, MPI_COMM_WORLD);
+
+    boardFormat = CHECKPOINT_BOARD;
+    numberOfCheckpointBlocks = header[1];
+    totalGenerations = header[3];
+    numberOfGenerations = header[3] - header[2];
+    masterBoard_columns = header[4];
+    masterBoard_rows = header[5];
+
+    snprintf(fileName, sizeof(fileName), "%s.%lld", restartFileName, header[0]);
+    MPI_File_open(MPI_COMM_WORLD, fileName, MPI_MODE_RDONLY, MPI_INFO_NULL, &boardFile);
+
+    //Every rank needs the whole table, but only the master has to read it
+    checkpointBlocks = malloc(sizeof(struct checkpointBlock) * numberOfCheckpointBlocks);
+
+    if(!identity)
+        MPI_File_read_at(boardFile, sizeof(struct checkpointHeader), checkpointBlocks, sizeof(struct checkpointBlock) * numberOfCheckpointBlocks, MPI_BYTE, &status);
+
+    MPI_Bcast(checkpointBlocks, sizeof(struct checkpointBlock) * numberOfCheckpointBlocks, MPI_BYTE, 0, MPI_COMM_WORLD);
+}
+
+/* Starts a random board in place of a board file. The size, density, seed and generations all came with -random, so every rank
+   already has everything it needs and nothing is read or sent */
+void openRandomBoard()
+{
+    boardFormat = RANDOM_BOARD;
+    totalGenerations = numberOfGenerations;
+    strcpy(boardRule, BOARD_FILE_RULE);
+}
+
+/* Allocates both board buffers for the local board's size, all dead. When the node's ranks share their boards, they come out of one
+   shared memory window that every rank on the node has to take part in allocating */
+void allocateBoards()
+{
+    MPI_Aint bytes;
+    MPI_Info info;
+
+    if(engine == PACKED_ENGINE)
+    {
+        localBoard_RowWords = packedRowWords(localBoard_Width);
+        bytes = sizeof(uint64_t) * localBoard_RowWords * localBoard_Height;
+    }
+    else
+        bytes = sizeof(char) * localBoard_Size;
+
+    boardWindow = MPI_WIN_NULL;
+
+    if(nodeComm != MPI_COMM_NULL)
+    {
+        //Each rank's part can go in memory close to it instead of all of them in one block
+        MPI_Info_create(&info);
+        MPI_Info_set(info, "alloc_shared_noncontig", "true");
+        MPI_Win_allocate_shared(2 * bytes, 1, info, nodeComm, &boardBuffers, &boardWindow);
+        MPI_Info_free(&info);
+
+        //Reads are ordered with MPI_Win_sync and messages, inside a single epoch that lasts as long as the window
+        MPI_Win_lock_all(MPI_MODE_NOCHECK, boardWindow);
+        memset(boardBuffers, 0, 2 * bytes);
+    }
+    else
+        boardBuffers = calloc(2 * bytes, 1);
+
+    if(engine == PACKED_ENGINE)
+    {
+        localPackedBoard = boardBuffers;
+        nextGenPackedBoard = localPackedBoard + localBoard_RowWords * localBoard_Height;
+    }
+    else
+    {
+        localBoard = boardBuffers;
+        nextGenBoard = localBoard + localBoard_Size;
+    }
+}
+
+/* Releases the board buffers, collectively with the rest of the node when they're shared */
+void freeBoards()
+{
+    if(boardWindow != MPI_WIN_NULL)
+    {
+        MPI_Win_unlock_all(boardWindow);
+        MPI_Win_free(&boardWindow);
+    }
+    else
+        free(boardBuffers);
+}
+
+/* Where a partition's cells are put together before storePartition(), all dead to start with. That's the local board itself with
+   one char per cell, or a scratch board to pack from with the packed engine */
+char * partitionCells()
+{
+    if(engine == PACKED_ENGINE)
+        return calloc(localBoard_Size, sizeof(char));
+
+    return localBoard;
+}
+
+/* Makes the padded board of one char per cell from partitionCells() our local board, packing it first if the packed engine is in use */
+void storePartition(char *cells)
+{
+    if(engine == PACKED_ENGINE)
+    {
+        //Pack each padded row into words
+        for(int k = 0; k < localBoard_Height; k++)
+            packRow(cells + k * localBoard_Width, localBoard_Width, localPackedBoard + k * localBoard_RowWords);
+
+        free(cells);
+    }
+}
+
+/* Collectively reads the rectangle of a text board described by fileType, and converts it into our board. Each row read is readWidth cells
+   followed by endingWidth bytes of line ending, which only the partitions along the east edge read to check the rows aren't too long.
+   Returns the offset in the file of the first thing that's wrong in our rectangle, or LLONG_MAX if it's all fine */
+long long readTextPartition(MPI_Datatype fileType, int startX, int startY, int readWidth, int readHeight, int endingWidth, int offsetX, int offsetY)
+{
+    char * fileCells;
+    char * cells;
+    long rowLength;
+    long long errorOffset;
+    MPI_Status status;
+
+    rowLength = readWidth + endingWidth;
+
+    //The last row doesn't need a line ending, so the end of what's read may be past the end of the file
+    fileCells = calloc(rowLength * readHeight + 1, sizeof(char));
+
+    MPI_File_set_view(boardFile, boardDataStart, MPI_CHAR, fileType, "native", MPI_INFO_NULL);
+    MPI_File_read_all(boardFile, fileCells, rowLength * readHeight, MPI_CHAR, &status);
+
+    //Back to seeing the file as plain bytes, so whatever's wrong with it can be found again
+    MPI_File_set_view(boardFile, 0, MPI_CHAR, MPI_CHAR, "native", MPI_INFO_NULL);
+
+    errorOffset = LLONG_MAX;
+
+    if(hasPartition)
+    {
+        MPI_Type_free(&fileType);
+
+        cells = partitionCells();
+
+        #pragma omp parallel for reduction(min:errorOffset) if(rowLength * readHeight >= PARALLEL_CELLS)
+        for(int k = 0; k < readHeight; k++)
+        {
+            const char *text = fileCells + k * rowLength;
+            int bad;
+
+            bad = parseTextCells(text, readWidth, cells + (k + offsetY) * localBoard_Width + offsetX);
+
+            //A row that's too long runs on into where its line ending should be
+            for(int e = 0; bad < 0 && e < endingWidth && startY + k < masterBoard_rows - 1; e++)
+                if(text[readWidth + e] != boardRowEnding[e])
+                    bad = readWidth + e;
+
+            if(bad >= 0 && boardDataStart + (long long)(startY + k) * boardRowStride + startX + bad < errorOffset)
+                errorOffset = boardDataStart + (long long)(startY + k) * boardRowStride + startX + bad;
+        }
+
+        storePartition(cells);
+    }
+
+    free(fileCells);
+
+    return errorOffset;
+}
+
+/* Makes up our piece of a random board, ghost cells included, the same way BoardGenerator does. Each cell comes from the seed and its
+   index on the whole board, so the board is the same however it's split, and no rank ever holds more than its own piece */
+void makeRandomPartition(int startX, int startY, int readWidth, int readHeight, int offsetX, int offsetY)
+{
+    char * cells;
+
+    cells = partitionCells();
+
+    #pragma omp parallel for if((long)readWidth * readHeight >= PARALLEL_CELLS)
+    for(int k = 0; k < readHeight; k++)
+    {
+        char *row = cells + (k + offsetY) * localBoard_Width + offsetX;
+        uint64_t index = (uint64_t)(startY + k) * masterBoard_columns + startX;
+
+        for(int x = 0; x < readWidth; x++)
+            row[x] = randomCell(randomSeed, index + x, randomDensity);
+    }
+
+    storePartition(cells);
+}
+
+/* Says exactly what's wrong at some offset in a text board, found by reading it again */
+void printTextPartitionError(long long errorOffset)
+{
+    char found;
+    int count;
+    MPI_Status status;
+
+    MPI_File_read_at(boardFile, errorOffset, &found, 1, MPI_CHAR, &status);
+    MPI_Get_count(&status, MPI_CHAR, &count);
+
+    printTextBoardError(boardFirstLine + (errorOffset - boardDataStart) / boardRowStride, (errorOffset - boardDataStart) % boardRowStride + 1, masterBoard_columns, count ? found : EOF);
+}
+
+/* Copies the rectangle starting at startX, startY out of a checkpoint. The checkpoint may have been written by a different number of ranks,
+   so the rectangle is put together from whichever of its blocks overlap it */
+void readCheckpointPartition(int startX, int startY, int readWidth, int readHeight, int offsetX, int offsetY)
+{
+    char * cells;
+    uint64_t * bits;
+    MPI_Status status;
+
+    cells = partitionCells();
+
+    for(int b = 0; b < numberOfCheckpointBlocks; b++)
+    {
+        struct checkpointBlock *block = &checkpointBlocks[b];
+        int blockX = (int)block->startX;
+        int blockY = (int)block->startY;
+        int blockWidth = (int)block->lengthX;
+        int blockHeight = (int)block->lengthY;
+        int x0 = blockX > startX ? blockX : startX;
+        int y0 = blockY > startY ? blockY : startY;
+        int x1 = blockX + blockWidth < startX + readWidth ? blockX + blockWidth : startX + readWidth;
+        int y1 = blockY + blockHeight < startY + readHeight ? blockY + blockHeight : startY + readHeight;
+        long firstWord;
+        long words;
+
+        if(x0 >= x1 || y0 >= y1)
+            continue;
+
+        //Only the words holding the overlapping rows are read
+        firstWord = (long)(y0 - blockY) * blockWidth / CELLS_PER_WORD;
+        words = ((long)(y1 - blockY) * blockWidth - 1) / CELLS_PER_WORD - firstWord + 1;
+        bits = malloc(sizeof(uint64_t) * words);
+
+        MPI_File_read_at(boardFile, block->offset + firstWord * sizeof(uint64_t), bits, words, MPI_UINT64_T, &status);
+
+        for(int y = y0; y < y1; y++)
+            for(int x = x0; x < x1; x++)
+                cells[(y - startY + offsetY) * localBoard_Width + x - startX + offsetX] = getPackedCell(bits, 0, (long)(y - blockY) * blockWidth + x - blockX - firstWord * CELLS_PER_WORD, 0);
+
+        free(bits);
+    }
+
+    storePartition(cells);
+}
+
+/* Reads our partition and the ghost cells around it straight out of the board file. Text boards are read through a file view of just that
+   rectangle, and since the read is collective every rank has to call this, ranks without a partition just read nothing. Binary boards are mapped
+   and our rows copied straight out of the mapping, and random boards are made up on the spot. No rank ever sees the whole board */
+void readPartition()
+{
+    int sizes[2];
+    int subsizes[2];
+    int starts[2];
+    int readWidth;
+    int readHeight;
+    int endingWidth;
+    int offsetX;
+    int offsetY;
+    char * cells;
+    int badCells;
+    int anyBadCells;
+    long long errorOffset;
+    long long firstErrorOffset;
+    MPI_Datatype fileType;
+    struct boardFile binaryBoard;
+
+    readWidth = 0;
+    readHeight = 0;
+    endingWidth = 0;
+    starts[0] = 0;
+    starts[1] = 0;
+    offsetX = 0;
+    offsetY = 0;
+    fileType = MPI_CHAR;
+
+    if(hasPartition)
+    {
+        //Ghost cells past the edge of the board aren't in the file, they're just dead
+        starts[1] = myCoords.startX - haloDepth < 0 ? 0 : myCoords.startX - haloDepth;
+        starts[0] = myCoords.startY - haloDepth < 0 ? 0 : myCoords.startY - haloDepth;
+        readWidth = (myCoords.startX + myCoords.lengthX + haloDepth > masterBoard_columns ? masterBoard_columns : myCoords.startX + myCoords.lengthX + haloDepth) - starts[1];
+        readHeight = (myCoords.startY + myCoords.lengthY + haloDepth > masterBoard_rows ? masterBoard_rows : myCoords.startY + myCoords.lengthY + haloDepth) - starts[0];
+
+        offsetX = starts[1] - (myCoords.startX - haloDepth);
+        offsetY = starts[0] - (myCoords.startY - haloDepth);
+
+        //Partitions on the east edge read the line endings too, to catch rows that are too long
+        if(myCoords.startX + myCoords.lengthX == masterBoard_columns)
+            endingWidth = boardRowStride - masterBoard_columns;
+
+        //The file is a rows by rowStride array of chars, line endings included
+        sizes[0] = masterBoard_rows;
+        sizes[1] = boardRowStride;
+        subsizes[0] = readHeight;
+        subsizes[1] = readWidth + endingWidth;
+
+        if(boardFormat == TEXT_BOARD)
+        {
+            MPI_Type_create_subarray(2, sizes, subsizes, starts, MPI_ORDER_C, MPI_CHAR, &fileType);
+            MPI_Type_commit(&fileType);
+        }
+    }
+
+    badCells = 0;
+
+    if(boardFormat == CHECKPOINT_BOARD)
+    {
+        if(hasPartition)
+            readCheckpointPartition(starts[1], starts[0], readWidth, readHeight, offsetX, offsetY);
+    }
+    else if(boardFormat == RANDOM_BOARD)
+    {
+        if(hasPartition)
+            makeRandomPartition(starts[1], starts[0], readWidth, readHeight, offsetX, offsetY);
+    }
+    else if(boardFormat == BINARY_BOARD)
+    {
+        if(hasPartition)
+        {
+            cells = partitionCells();
+
+            if(mapBoardFile(boardFileName, &binaryBoard))
+            {
+                readBoardCells(&binaryBoard, starts[1], starts[0], readWidth, readHeight, cells + offsetY * localBoard_Width + offsetX, localBoard_Width);
+                unmapBoardFile(&binaryBoard);
+            }
+            else
+                badCells = 1;
+
+            storePartition(cells);
+        }
+
+        MPI_Allreduce(&badCells, &anyBadCells, 1, MPI_INT, MPI_LOR, MPI_COMM_WORLD);
+
+        if(anyBadCells)
+        {
+            if(!identity)
+                printf("Your file specification's jacked up, might want to check it out.");
+            exit(1);
+        }
+    }
+    else
+    {
+        errorOffset = readTextPartition(fileType, starts[1], starts[0], readWidth, readHeight, endingWidth, offsetX, offsetY);
+
+        //The first mistake in the file is the one reported, whoever found it
+        MPI_Allreduce(&errorOffset, &firstErrorOffset, 1, MPI_LONG_LONG, MPI_MIN, MPI_COMM_WORLD);
+
+        if(firstErrorOffset != LLONG_MAX)
+        {
+            if(!identity)
+                printTextPartitionError(firstErrorOffset);
+            exit(1);
+        }
+    }
+}
+
+/* Brings every partition's current board together in masterBoard on the master with a single gather. Only the cells inside each partition
+   travel: char boards are sent with a datatype that skips the ghost cells, and packed boards send their cells as a packed bit stream */
+void gatherBoard()
+{
+    int numberOfProcessors;
+    int sendCount;
+    int *counts;
+    int *displacements;
+    void *sendBuffer;
+    uint64_t *packedCells;
+    char *gatheredCells;
+    MPI_Datatype sendType;
+    MPI_Datatype cellType;
+
+    MPI_Comm_size(boardComm, &numberOfProcessors);
+
+    cellType = (engine == PACKED_ENGINE) ? MPI_UINT64_T : MPI_CHAR;
+    sendType = cellType;
+    sendCount = 0;
+    sendBuffer = NULL;
+    packedCells = NULL;
+
+    if(hasPartition)
+    {
+        if(engine == PACKED_ENGINE)
+        {
+            sendCount = packedEdgeWords(myCoords.lengthX, myCoords.lengthY);
+            packedCells = malloc(sizeof(uint64_t) * sendCount);
+            packRegion(localPackedBoard, localBoard_RowWords, haloDepth, haloDepth, myCoords.lengthX, myCoords.lengthY, packedCells);
+            sendBuffer = packedCells;
+        }
+        else
+        {
+            MPI_Type_vector(myCoords.lengthY, myCoords.lengthX, localBoard_Width, MPI_CHAR, &sendType);
+            MPI_Type_commit(&sendType);
+            sendCount = 1;
+            sendBuffer = localBoard + haloDepth * localBoard_Width + haloDepth;
+        }
+    }
+
+    counts = NULL;
+    displacements = NULL;
+    gatheredCells = NULL;
+
+    if(!identity) //If we are the master (process 0)
+    {
+        counts = calloc(numberOfProcessors, sizeof(int));
+        displacements = calloc(numberOfProcessors, sizeof(int));
+
+        for(int i = 0; i < actualPartitions; i++)
+            counts[partitionOwners[i]] = (engine == PACKED_ENGINE) ? packedEdgeWords(partitionArray[i].lengthX, partitionArray[i].lengthY) : partitionArray[i].lengthX * partitionArray[i].lengthY;
+
+        for(int r = 1; r < numberOfProcessors; r++)
+            displacements[r] = displacements[r - 1] + counts[r - 1];
+
+        gatheredCells = malloc((engine == PACKED_ENGINE ? sizeof(uint64_t) : sizeof(char)) * (displacements[numberOfProcessors - 1] + counts[numberOfProcessors - 1]));
+
+        if(masterBoard == NULL)
+        {
+            masterBoard = malloc(sizeof(char) * masterBoard_columns * masterBoard_rows);
+            allocatedMemory[numberOfMemoryAllocations++] = masterBoard;
+        }
+    }
+
+    MPI_Gatherv(sendBuffer, sendCount, sendType, gatheredCells, counts, displacements, cellType, 0, boardComm);
+
+    if(!identity)
+    {
+        //Each partition arrived as a block of its rows, which get copied into place
+        #pragma omp parallel for schedule(dynamic)
+        for(int i = 0; i < actualPartitions; i++)
+        {
+            struct partition *piece = &partitionArray[i];
+            char *destination = masterBoard + piece->startX + (long)piece->startY * masterBoard_columns;
+
+            if(engine == PACKED_ENGINE)
+            {
+                uint64_t *bits = (uint64_t *)gatheredCells + displacements[partitionOwners[i]];
+
+                for(int k = 0; k < piece->lengthY; k++)
+                    for(int j = 0; j < piece->lengthX; j++)
+                        destination[(long)k * masterBoard_columns + j] = getPackedCell(bits, 0, k * piece->lengthX + j, 0);
+            }
+            else
+            {
+                for(int k = 0; k < piece->lengthY; k++)
+                    memcpy(destination + (long)k * masterBoard_columns, gatheredCells + displacements[partitionOwners[i]] + k * piece->lengthX, piece->lengthX);
+            }
+        }
+    }
+
+    if(hasPartition && engine != PACKED_ENGINE)
+        MPI_Type_free(&sendType);
+
+    free(packedCells);
+    free(gatheredCells);
+    free(counts);
+    free(displacements);
+}
+
+/* The reverse of gatherBoard(): hands each partition its cells back out of masterBoard with one MPI_Scatterv. Only used with the
+   hashlife engine, whose boards are always one char per cell */
+void scatterBoard()
+{
+    int numberOfProcessors;
+    int receiveCount;
+    int *counts;
+    int *displacements;
+    char *scatteredCells;
+    MPI_Datatype receiveType;
+
+    MPI_Comm_size(boardComm, &numberOfProcessors);
+
+    receiveType = MPI_CHAR;
+    receiveCount = 0;
+
+    if(hasPartition)
+    {
+        MPI_Type_vector(myCoords.lengthY, myCoords.lengthX, localBoard_Width, MPI_CHAR, &receiveType);
+        MPI_Type_commit(&receiveType);
+        receiveCount = 1;
+    }
+
+    counts = NULL;
+    displacements = NULL;
+    scatteredCells = NULL;
+
+    if(!identity)
+    {
+        counts = calloc(numberOfProcessors, sizeof(int));
+        displacements = calloc(numberOfProcessors, sizeof(int));
+
+        for(int i = 0; i < actualPartitions; i++)
+            counts[partitionOwners[i]] = partitionArray[i].lengthX * partitionArray[i].lengthY;
+
+        for(int r = 1; r < numberOfProcessors; r++)
+            displacements[r] = displacements[r - 1] + counts[r - 1];
+
+        scatteredCells = malloc(sizeof(char) * (displacements[numberOfProcessors - 1] + counts[numberOfProcessors - 1]));
+
+        for(int i = 0; i < actualPartitions; i++)
+        {
+            struct partition *piece = &partitionArray[i];
+            char *source = masterBoard + piece->startX + (long)piece->startY * masterBoard_columns;
+
+            for(int k = 0; k < piece->lengthY; k++)
+                memcpy(scatteredCells + displacements[partitionOwners[i]] + k * piece->lengthX, source + (long)k * masterBoard_columns, piece->lengthX);
+        }
+    }
+
+    MPI_Scatterv(scatteredCells, counts, displacements, MPI_CHAR, hasPartition ? localBoard + haloDepth * localBoard_Width + haloDepth : NULL,
+                 receiveCount, receiveType, 0, boardComm);
+
+    if(hasPartition)
+        MPI_Type_free(&receiveType);
+
+    free(scatteredCells);
+    free(counts);
+    free(displacements);
+}
+
+/* Prints masterBoard a row at a time, only meaningful on the master */
+void printBoard()
+{
+    char *line;
+
+    line = malloc(sizeof(char) * (masterBoard_columns + 1));
+    line[masterBoard_columns] = '\n';
+
+    for(int k = 0; k < masterBoard_rows; k++)
+    {
+        for(int j = 0; j < masterBoard_columns; j++)
+            line[j] = masterBoard[(long)k * masterBoard_columns + j] ? '*' : '.';
+
+        fwrite(line, sizeof(char), masterBoard_columns + 1, stdout);
+    }
+
+    free(line);
+}
+
+/* Writes the board to outputFileName as a text board, which can be read back in to carry on from here. Every rank writes its own rows
+   straight into their place in the file through a file view, all at once, so the board is never gathered anywhere */
+void writeBoard()
+{
+    MPI_File outputFile;
+    MPI_Datatype fileType;
+    MPI_Status status;
+    char header[128];
+    int headerLength;
+    int sizes[2];
+    int subsizes[2];
+    int starts[2];
+    int lineWidth;
+    char *text;
+
+    //Every rank can work out how long the header is, so nobody has to wait for it to be written
+    headerLength = sprintf(header, "%d\n%d\n%d\n", totalGenerations, masterBoard_columns, masterBoard_rows);
+
+    //The rule only goes in when it isn't the one boards are for by default, so B3/S23 boards come out as they always have
+    if(strcmp(rule.name, BOARD_FILE_RULE) != 0)
+        headerLength += sprintf(header + headerLength, "%s\n", rule.name);
+
+    if(MPI_File_open(boardComm, outputFileName, MPI_MODE_CREATE | MPI_MODE_WRONLY, MPI_INFO_NULL, &outputFile) != MPI_SUCCESS)
+    {
+        if(!identity)
+            printf("Could not create %s\n", outputFileName);
+        exit(1);
+    }
+
+    MPI_File_set_size(outputFile, headerLength + (MPI_Offset)masterBoard_rows * (masterBoard_columns + 1));
+
+    if(!identity)
+        MPI_File_write_at(outputFile, 0, header, headerLength, MPI_CHAR, &status);
+
+    lineWidth = 0;
+    text = NULL;
+    fileType = MPI_CHAR;
+
+    if(hasPartition)
+    {
+        //Partitions along the east edge write the end of each line too
+        lineWidth = myCoords.lengthX + (myCoords.startX + myCoords.lengthX == masterBoard_columns);
+        text = malloc(sizeof(char) * lineWidth * myCoords.lengthY);
+
+        #pragma omp parallel for if((long)lineWidth * myCoords.lengthY >= PARALLEL_CELLS)
+        for(int k = 0; k < myCoords.lengthY; k++)
+        {
+            for(int j = 0; j < myCoords.lengthX; j++)
+            {
+                if(engine == PACKED_ENGINE)
+                    text[k * lineWidth + j] = getPackedCell(localPackedBoard, localBoard_RowWords, j + haloDepth, k + haloDepth) ? '*' : '.';
+                else
+                    text[k * lineWidth + j] = getArray(j + haloDepth, k + haloDepth) ? '*' : '.';
+            }
+
+            if(lineWidth > myCoords.lengthX)
+                text[k * lineWidth + myCoords.lengthX] = '\n';
+        }
+
+        //The board part of the file is a rows by columns + 1 array of chars
+        sizes[0] = masterBoard_rows;
+        sizes[1] = masterBoard_columns + 1;
+        subsizes[0] = myCoords.lengthY;
+        subsizes[1] = lineWidth;
+        starts[0] = myCoords.startY;
+        starts[1] = myCoords.startX;
+
+        MPI_Type_create_subarray(2, sizes, subsizes, starts, MPI_ORDER_C, MPI_CHAR, &fileType);
+        MPI_Type_commit(&fileType);
+    }
+
+    MPI_File_set_view(outputFile, headerLength, MPI_CHAR, fileType, "native", MPI_INFO_NULL);
+    MPI_File_write_all(outputFile, text, lineWidth * (hasPartition ? myCoords.lengthY : 0), MPI_CHAR, &status);
+
+    MPI_File_close(&outputFile);
+
+    if(hasPartition)
+        MPI_Type_free(&fileType);
+
+    free(text);
+}
+
+/* Called when the final board configurations have been calculated, all processes submit their sections for gather, or write them out */
+void finalizeBoard()
+{
+    TIMING_START(TIMING_OUTPUT);
+
+    if(outputFileName != NULL)
+    {
+        writeBoard();
+
+        if(!identity)
+            printf("\nFinal board written to %s\n", outputFileName);
+    }
+    else if(!quiet)
+    {
+        gatherBoard();
+
+        if(!identity) //If we are the master (process 0)
+        {
+            printf("\nFinal board configuration: \n");
+
+            printBoard();
+        }
+    }
+
+    TIMING_STOP(TIMING_OUTPUT);
+
+    //Ranks, threads per rank, engine, columns, rows, generations, seconds, seconds per generation, cells updated per second
+    if(quiet && !identity)
+        printf("%d,%d,%s,%d,%d,%d,%.6f,%.9f,%.0f\n", actualPartitions, threadCount(), engineName(engine), masterBoard_columns, masterBoard_rows,
+               generationsToRun, runSeconds, generationsToRun > 0 ? runSeconds / generationsToRun : 0,
+               runSeconds > 0 ? (double)masterBoard_columns * masterBoard_rows * generationsToRun / runSeconds : 0);
+
+    if(!identity)
+        freeMemory();
+}
+
+/* Lets the master know which rank ended up with each partition in the grid */
+void findPartitionOwners()
+{
+    int numberOfProcessors;
+    int *heldPartitions;
+
+    if(!hasPartition)
+        return;
+
+    MPI_Comm_size(boardComm, &numberOfProcessors);
+
+    heldPartitions = malloc(sizeof(int) * numberOfProcessors);
+
+    MPI_Gather(&myPartition, 1, MPI_INT, heldPartitions, 1, MPI_INT, 0, boardComm);
+
+    if(!identity)
+    {
+        partitionOwners = malloc(sizeof(int) * actualPartitions);
+
+        for(int r = 0; r < numberOfProcessors; r++)
+            if(heldPartitions[r] > -1)
+                partitionOwners[heldPartitions[r]] = r;
+    }
+
+    free(heldPartitions);
+}
+
+/* Settles on the rule, the one given with -rule or else the one the board is for, makes sure the engine and tiles can run it, and gets
+   the engine's kernel ready for it before any threads use it */
+void chooseRule()
+{
+    const char *text;
+
+    text = (ruleText != NULL) ? ruleText : boardRule;
+
+    if(!parseRule(text, &rule))
+    {
+        if(!identity)
+            printf("Unknown rule %s, expected something like B3/S23, 23/3 or R2,C0,M1,S2..5,B4..5,NM\n", text);
+        exit(1);
+    }
+
+    //The other engines all count the 3x3 block around a cell
+    if(rule.radius > 1 && engine != CELL_ENGINE)
+    {
+        if(!identity)
+            printf("Only the cell engine runs rules that reach more than one cell out, like %s\n", rule.name);
+        exit(1);
+    }
+
+    //Hashlife's board goes on forever, and empty space would come alive everywhere at once
+    if(engine == HASHLIFE_ENGINE && (rule.birth & 1))
+    {
+        if(!identity)
+            printf("The hashlife engine can't run rules where cells are born with no neighbors, like %s\n", rule.name);
+        exit(1);
+    }
+
+    //A tile is only recomputed when the ones touching it change, so a cell can't reach past those
+    if(tileSize > 0 && tileSize < rule.radius)
+    {
+        if(!identity)
+            printf("Tiles have to be at least as big as the rule reaches, %d cells\n", rule.radius);
+        exit(1);
+    }
+
+    if(!identity && !quiet && strcmp(rule.name, BOARD_FILE_RULE) != 0)
+        printf("Running the rule %s\n", rule.name);
+
+    if(engine == SIMD_ENGINE)
+    {
+        simdISA chosen = initSimdKernel(maximumISA, rule.birth, rule.survival);
+
+        if(!identity && !quiet)
+            printf("Using the %s row sweep\n", simdISAName(chosen));
+    }
+    else if(engine == PACKED_ENGINE)
+        initPackedKernel(rule.birth, rule.survival);
+    else if(engine == LOOKUP_ENGINE)
+        initLookupKernel(rule.birth, rule.survival);
+    else if(rule.radius > 1)
+        initLargerKernel(&rule);
+}
+
+/* Initializes the board. Every rank lays out the partitions the same way from the file's header (or -random), then reads its own piece of the board */
+void initializeBoard()
+{
+    int numberOfProcessors;
+
+    TIMING_START(TIMING_LOAD);
+
+    if(restartFileName != NULL)
+        openCheckpoint();
+    else if(randomBoard)
+        openRandomBoard();
+    else
+        openBoardFile();
+
+    chooseRule();
+
+    TIMING_STOP(TIMING_LOAD);
+    TIMING_START(TIMING_PARTITION);
+
+    MPI_Comm_size(MPI_COMM_WORLD, &numberOfProcessors);
+
+    actualPartitions = numberOfProcessors;
+    partitionArray = generateBoard(masterBoard_columns, masterBoard_rows, &actualPartitions, &partitionsX, &partitionsY);
+
+    if(!identity)
+    {
+        if(!quiet)
+            printf("Forcing %d partitions\n", actualPartitions);
+
+        if(actualPartitions < numberOfProcessors)
+            printf("The board can't be split into a grid of %d partitions, so %d of the processes will sit out\n", numberOfProcessors, numberOfProcessors - actualPartitions);
+    }
+
+    //Every ghost region has to come from a single neighbor, so the halo can't be deeper than the smallest partition across the way it's
+    //split. Each generation between exchanges uses up the rule's radius of it
+    for(int i = 0; i < actualPartitions; i++)
+    {
+        if(partitionsX > 1 && haloGenerations * rule.radius > partitionArray[i].lengthX)
+            haloGenerations = partitionArray[i].lengthX / rule.radius;
+        if(partitionsY > 1 && haloGenerations * rule.radius > partitionArray[i].lengthY)
+            haloGenerations = partitionArray[i].lengthY / rule.radius;
+    }
+
+    if(haloGenerations < 1)
+    {
+        if(!identity)
+            printf("The partitions are narrower than the rule reaches (%d cells), try fewer processes\n", rule.radius);
+        exit(1);
+    }
+
+    haloDepth = haloGenerations * rule.radius;
+
+    //A tile's generations ahead can only depend on the tiles around it, not the ones past those
+    if(temporalBlocking && haloDepth > tileSize)
+    {
+        if(!identity)
+            printf("Temporal blocking works a tile at a time, so it needs tiles at least as big as the halo is deep (%d)\n", haloDepth);
+        exit(1);
+    }
+
+    if(!identity && !quiet)
+        printf("Exchanging a halo %d deep every %d generations\n", haloDepth, haloGenerations);
+
+    createTopology();
+
+    findPartitionOwners();
+
+    TIMING_STOP(TIMING_PARTITION);
+    TIMING_START(TIMING_READ);
+
+    if(hasPartition)//If we are a process with work to do
+    {
+        localBoard_Width = myCoords.lengthX + 2 * haloDepth;
+        localBoard_Height = myCoords.lengthY + 2 * haloDepth;
+        localBoard_Size = localBoard_Width * localBoard_Height;
+
+        //The ghost ring of the next generation is only ever written by neighbors, so it has to start out dead
+        allocateBoards();
+    }
+
+    readPartition();
+
+    if(boardFormat != RANDOM_BOARD)
+        MPI_File_close(&boardFile);
+
+    TIMING_STOP(TIMING_READ);
+
+    //Big boards are written to a file rather than printed, so they aren't printed at the start either
+    if(outputFileName == NULL && !quiet && hasPartition)
+    {
+        TIMING_START(TIMING_PRINT);
+
+        gatherBoard();
+
+        if(!identity)
+        {
+            printf("\nInitial board: \n");
+
+            printBoard();
+        }
+
+        TIMING_STOP(TIMING_PRINT);
+    }
+
+    if(hasPartition)
+    {
+        TIMING_START(TIMING_SETUP);
+        setupTiles();
+        setupHaloExchange();
+        TIMING_STOP(TIMING_SETUP);
+    }
+    //Non-working processes do nothing.
+}
+
+/* Computes the next generation of the cells x0 to x1 of rows y0 to y1 with whichever engine is in use */
+void calculateCells(int x0, int y0, int x1, int y1)
+{
+    if(engine == PACKED_ENGINE)
+        calculatePackedBoard(localPackedBoard, nextGenPackedBoard, localBoard_RowWords, x0, y0, x1, y1);
+    else if(engine == SIMD_ENGINE)
+        calculateSimdBoard(localBoard, nextGenBoard, localBoard_Width, x0, y0, x1, y1);
+    else if(engine == LOOKUP_ENGINE)
+        calculateLookupBoard(localBoard, nextGenBoard, localBoard_Width, x0, y0, x1, y1);
+    else if(rule.radius > 1)
+        calculateLargerBoard(localBoard, nextGenBoard, localBoard_Width, x0, y0, x1, y1);
+    else
+    {
+        #pragma omp parallel for if((long)(x1 - x0 + 1) * (y1 - y0 + 1) >= PARALLEL_CELLS)
+        for(int j = y0; j <= y1; j++)
+        {
+            for(int i = x0; i <= x1; i++)
+            {
+                if(isAlive(localBoard, localBoard_Width, localBoard_Height, i, j))
+                    setNextArray(i, j, 1);
+                else
+                    setNextArray(i, j, 0);
+            }
+        }
+    }
+}
+
+/* Computes the next generation of the cells x0 to x1 of rows y0 to y1. Empty regions are skipped, and so are tiles where nothing
+   changed nearby unless every tile is asked for. Tiles are spread over the threads instead of the rows within them */
+void calculateRegion(int x0, int y0, int x1, int y1, bool allTiles)
+{
+    int tileX0;
+    int tileY0;
+    int tileCount;
+    int tileWidth;
+
+    if(x0 > x1 || y0 > y1)
+        return;
+
+    if(tileSize == 0)
+    {
+        calculateCells(x0, y0, x1, y1);
+        return;
+    }
+
+    //Nothing anywhere changed, so nothing can
+    if(changedTiles == 0 && !allTiles)
+        return;
+
+    tileX0 = x0 / tileSize;
+    tileY0 = y0 / tileSize;
+    tileWidth = x1 / tileSize - tileX0 + 1;
+    tileCount = tileWidth * (y1 / tileSize - tileY0 + 1);
+
+    #pragma omp parallel for schedule(dynamic) reduction(+:nextChangedTiles) if((long)(x1 - x0 + 1) * (y1 - y0 + 1) >= PARALLEL_CELLS)
+    for(int t = 0; t < tileCount; t++)
+    {
+        int tileX = tileX0 + t % tileWidth;
+        int tileY = tileY0 + t / tileWidth;
+        int i0 = (tileX * tileSize > x0) ? tileX * tileSize : x0;
+        int j0 = (tileY * tileSize > y0) ? tileY * tileSize : y0;
+        int i1 = ((tileX + 1) * tileSize - 1 < x1) ? (tileX + 1) * tileSize - 1 : x1;
+        int j1 = ((tileY + 1) * tileSize - 1 < y1) ? (tileY + 1) * tileSize - 1 : y1;
+
+        if(!allTiles && !tileActive(tileX, tileY))
+            continue;
+
+        calculateCells(i0, j0, i1, j1);
+        tileWork[tileX + tileY * tilesX]++;
+
+        //A tile can be computed in more than one piece, but only one piece of it is ever in a region
+        if(!nextTileChanged[tileX + tileY * tilesX] && regionChanged(i0, j0, i1, j1))
+        {
+            nextTileChanged[tileX + tileY * tilesX] = 1;
+            nextChangedTiles++;
+        }
+    }
+}
+
+/* Computes the cells of the outer region that aren't in the inner one (which sits inside it). An empty inner region means all of it */
+void calculateRing(int x0, int y0, int x1, int y1, int innerX0, int innerY0, int innerX1, int innerY1, bool allTiles)
+{
+    if(innerX0 > innerX1 || innerY0 > innerY1)
+    {
+        calculateRegion(x0, y0, x1, y1, allTiles);
+        return;
+    }
+
+    calculateRegion(x0, y0, x1, innerY0 - 1, allTiles);
+    calculateRegion(x0, innerY1 + 1, x1, y1, allTiles);
+    calculateRegion(x0, innerY0, innerX0 - 1, innerY1, allTiles);
+    calculateRegion(innerX1 + 1, innerY0, x1, innerY1, allTiles);
+}
+
+/* Finds the part of a tile that's our own cells, false if it's all ghost region */
+bool tileCells(int tileX, int tileY, int *x0, int *y0, int *x1, int *y1)
+{
+    *x0 = (tileX * tileSize > haloDepth) ? tileX * tileSize : haloDepth;
+    *y0 = (tileY * tileSize > haloDepth) ? tileY * tileSize : haloDepth;
+    *x1 = ((tileX + 1) * tileSize - 1 < haloDepth + myCoords.lengthX - 1) ? (tileX + 1) * tileSize - 1 : haloDepth + myCoords.lengthX - 1;
+    *y1 = ((tileY + 1) * tileSize - 1 < haloDepth + myCoords.lengthY - 1) ? (tileY + 1) * tileSize - 1 : haloDepth + myCoords.lengthY - 1;
+
+    return *x0 <= *x1 && *y0 <= *y1;
+}
+
+/* Mask of the bits of packed word w that hold cells x0 to x1 */
+uint64_t packedWordMask(int w, int x0, int x1)
+{
+    uint64_t mask;
+
+    mask = ~(uint64_t)0;
+
+    if(w * CELLS_PER_WORD < x0)
+        mask &= ~(uint64_t)0 << (x0 - w * CELLS_PER_WORD);
+
+    if(w * CELLS_PER_WORD + CELLS_PER_WORD - 1 > x1)
+        mask &= ~(uint64_t)0 >> (w * CELLS_PER_WORD + CELLS_PER_WORD - 1 - x1);
+
+    return mask;
+}
+
+/* Takes our cells x0 to x1 of rows y0 to y1 some generations (no more than haloGenerations) ahead and writes them into nextGenBoard.
+   Everything within that many radii of them is copied into both scratch buffers, which then trade places each generation
+   while the part computed shrinks by the rule's radius on every side, a trapezoid in time. Cells past a side of the board with no
+   neighbor are never computed so they stay dead. Packed boards are copied whole words at a time so the bits keep their
+   places within a word. Returns whether the cells came out any different from how they are in localBoard */
+bool calculateTileGenerations(int x0, int y0, int x1, int y1, int generations, void *scratch[2])
+{
+    int lowX;
+    int lowY;
+    int highX;
+    int highY;
+    int copyX0;
+    int copyY0;
+    int copyX1;
+    int copyY1;
+    int reach;      //How far the generations can reach
+    int offsetX;    //Column of the board that the scratch buffers start at
+    int width;      //Chars or words per scratch row
+    int height;
+    bool changed;
+    char *cells;
+    uint64_t *words;
+
+    lowX = (myNeighborIDs[3] > -1) ? 0 : haloDepth;
+    lowY = (myNeighborIDs[1] > -1) ? 0 : haloDepth;
+    highX = (myNeighborIDs[4] > -1) ? localBoard_Width - 1 : haloDepth + myCoords.lengthX - 1;
+    highY = (myNeighborIDs[6] > -1) ? localBoard_Height - 1 : haloDepth + myCoords.lengthY - 1;
+
+    reach = generations * rule.radius;
+    copyX0 = (x0 - reach > 0) ? x0 - reach : 0;
+    copyY0 = (y0 - reach > 0) ? y0 - reach : 0;
+    copyX1 = (x1 + reach < localBoard_Width - 1) ? x1 + reach : localBoard_Width - 1;
+    copyY1 = (y1 + reach < localBoard_Height - 1) ? y1 + reach : localBoard_Height - 1;
+    height = copyY1 - copyY0 + 1;
+
+    if(engine == PACKED_ENGINE)
+    {
+        offsetX = (copyX0 / CELLS_PER_WORD) * CELLS_PER_WORD;
+        width = copyX1 / CELLS_PER_WORD - copyX0 / CELLS_PER_WORD + 1;
+
+        for(int k = 0; k < 2; k++)
+            for(int j = 0; j < height; j++)
+                memcpy((uint64_t *)scratch[k] + j * width, localPackedBoard + (copyY0 + j) * localBoard_RowWords + offsetX / CELLS_PER_WORD, sizeof(uint64_t) * width);
+    }
+    else
+    {
+        offsetX = copyX0;
+        width = copyX1 - copyX0 + 1;
+
+        for(int k = 0; k < 2; k++)
+            for(int j = 0; j < height; j++)
+                memcpy((char *)scratch[k] + j * width, localBoard + (copyY0 + j) * localBoard_Width + copyX0, width);
+    }
+
+    for(int step = 0; step < generations; step++)
+    {
+        int grow = (generations - 1 - step) * rule.radius;
+        int i0 = ((x0 - grow > lowX) ? x0 - grow : lowX) - offsetX;
+        int j0 = ((y0 - grow > lowY) ? y0 - grow : lowY) - copyY0;
+        int i1 = ((x1 + grow < highX) ? x1 + grow : highX) - offsetX;
+        int j1 = ((y1 + grow < highY) ? y1 + grow : highY) - copyY0;
+        void *from = scratch[step % 2];
+        void *to = scratch[(step + 1) % 2];
+
+        if(engine == PACKED_ENGINE)
+            calculatePackedBoard(from, to, width, i0, j0, i1, j1);
+        else if(engine == SIMD_ENGINE)
+            calculateSimdBoard(from, to, width, i0, j0, i1, j1);
+        else if(engine == LOOKUP_ENGINE)
+            calculateLookupBoard(from, to, width, i0, j0, i1, j1);
+        else if(rule.radius > 1)
+            calculateLargerBoard(from, to, width, i0, j0, i1, j1);
+        else
+        {
+            for(int j = j0; j <= j1; j++)
+                for(int i = i0; i <= i1; i++)
+                    ((char *)to)[i + j * width] = isAlive(from, width, height, i, j);
+        }
+    }
+
+    changed = false;
+    cells = scratch[generations % 2];
+    words = scratch[generations % 2];
+
+    for(int j = y0; j <= y1; j++)
+    {
+        if(engine == PACKED_ENGINE)
+        {
+            for(int w = x0 / CELLS_PER_WORD; w <= x1 / CELLS_PER_WORD; w++)
+            {
+                uint64_t mask = packedWordMask(w, x0, x1);
+                uint64_t result = words[(j - copyY0) * width + w - offsetX / CELLS_PER_WORD] & mask;
+
+                changed |= (localPackedBoard[j * localBoard_RowWords + w] & mask) != result;
+                nextGenPackedBoard[j * localBoard_RowWords + w] = (nextGenPackedBoard[j * localBoard_RowWords + w] & ~mask) | result;
+            }
+        }
+        else
+        {
+            const char *result = cells + (j - copyY0) * width + x0 - offsetX;
+
+            changed |= memcmp(localBoard + j * localBoard_Width + x0, result, x1 - x0 + 1) != 0;
+            memcpy(nextGenBoard + j * localBoard_Width + x0, result, x1 - x0 + 1);
+        }
+    }
+
+    return changed;
+}
+
+/* Takes every tile that depends on the ghost region (or every one that doesn't) some generations ahead, one tile per thread at a time.
+   If nothing in a tile or around it changed over the last exchange's worth of generations, then everything it depends on is the same
+   in both buffers, so it's bound to come out as it already is in nextGenBoard. That only holds for a whole exchange's worth though,
+   so a shorter run at the very end does every tile */
+void calculateTiles(int generations, bool nearGhosts)
+{
+    bool allTiles;
+    int reach;
+
+    allTiles = generations < haloGenerations;
+    reach = generations * rule.radius;
+
+    if(changedTiles == 0 && !allTiles)
+        return;
+
+    #pragma omp parallel reduction(+:nextChangedTiles)
+    {
+        int side = tileSize + 2 * haloDepth;
+        void *scratch[2];
+
+        //Big enough for the tile and what's around it either as chars or as whole words
+        for(int k = 0; k < 2; k++)
+            scratch[k] = malloc((size_t)side * (side > (side / CELLS_PER_WORD + 2) * 8 ? side : (side / CELLS_PER_WORD + 2) * 8));
+
+        #pragma omp for schedule(dynamic)
+        for(int t = 0; t < tilesX * tilesY; t++)
+        {
+            int tileX = t % tilesX;
+            int tileY = t / tilesX;
+            int x0;
+            int y0;
+            int x1;
+            int y1;
+
+            if(!tileCells(tileX, tileY, &x0, &y0, &x1, &y1))
+                continue;
+
+            //Whether the cells it depends on reach into a ghost region that's being received
+            if(((x0 - reach < haloDepth && myNeighborIDs[3] > -1) || (y0 - reach < haloDepth && myNeighborIDs[1] > -1)
+                || (x1 + reach >= haloDepth + myCoords.lengthX && myNeighborIDs[4] > -1)
+                || (y1 + reach >= haloDepth + myCoords.lengthY && myNeighborIDs[6] > -1)) != nearGhosts)
+                continue;
+
+            if(!allTiles && !tileActive(tileX, tileY))
+                continue;
+
+            tileWork[t] += generations;
+
+            if(calculateTileGenerations(x0, y0, x1, y1, generations, scratch))
+            {
+                nextTileChanged[t] = 1;
+                nextChangedTiles++;
+            }
+        }
+
+        free(scratch[0]);
+        free(scratch[1]);
+    }
+}
+
+/* Decides whether to checkpoint after some generation. Every rank has to come to the same answer, so with a time limit the master
+   decides and tells everyone with a nonblocking broadcast, which is only waited on CHECKPOINT_POLL generations later */
+bool checkpointDue(int generation)
+{
+    bool due;
+
+    if(checkpointSeconds <= 0)
+        return generation % checkpointGenerations == 0;
+
+    if(generation % CHECKPOINT_POLL != 0)
+        return false;
+
+    due = false;
+
+    if(checkpointPollPending)
+    {
+        MPI_Wait(&checkpointPollRequest, MPI_STATUS_IGNORE);
+        due = checkpointPollDecision;
+    }
+
+    if(!identity)
+    {
+        checkpointPollDecision = (MPI_Wtime() - lastCheckpointTime >= checkpointSeconds);
+
+        if(checkpointPollDecision)
+            lastCheckpointTime = MPI_Wtime();
+    }
+
+    MPI_Ibcast(&checkpointPollDecision, 1, MPI_INT, 0, boardComm, &checkpointPollRequest);
+    checkpointPollPending = true;
+
+    return due;
+}
+
+/* Opens both checkpoint files for the whole run, so checkpoints after the first don't have to wait on a collective open */
+void openCheckpointFiles()
+{
+    char fileName[FILENAME_MAX];
+
+    for(int slot = 0; slot < 2; slot++)
+    {
+        snprintf(fileName, sizeof(fileName), "%s.%d", checkpointFileName, slot);
+
+        if(MPI_File_open(boardComm, fileName, MPI_MODE_CREATE | MPI_MODE_WRONLY, MPI_INFO_NULL, &checkpointFiles[slot]) != MPI_SUCCESS)
+        {
+            if(!identity)
+                printf("Could not create %s\n", fileName);
+            exit(1);
+        }
+
+        checkpointBlank[slot] = false;
+    }
+
+    checkpointFilesOpen = true;
+}
+
+/* Blanks the magic of one of the checkpoint files and waits for that to be on disk, so whatever it held stops counting as complete
+   before any of it is overwritten */
+void blankCheckpoint(int slot)
+{
+    char magic[sizeof(((struct checkpointHeader *)0)->magic)];
+
+    memset(magic, 0, sizeof(magic));
+
+    if(!identity)
+        MPI_File_write_at(checkpointFiles[slot], 0, magic, sizeof(magic), MPI_CHAR, MPI_STATUS_IGNORE);
+
+    MPI_File_sync(checkpointFiles[slot]);
+
+    checkpointBlank[slot] = true;
+}
+
+/* Waits for the checkpoint being written to one of the files to land, then marks it complete. If another checkpoint may follow, the other
+   file is blanked ready for it, since this one now stands in for whatever it held */
+void finishCheckpoint(int slot, bool another)
+{
+    char fileName[FILENAME_MAX];
+
+    if(!checkpointPending[slot])
+        return;
+
+    MPI_Wait(&checkpointHeaderRequests[slot], MPI_STATUS_IGNORE);
+    MPI_Wait(&checkpointRequests[slot], MPI_STATUS_IGNORE);
+
+    //Only once the header and every block are on disk does the checkpoint get its magic, and count as complete
+    MPI_File_sync(checkpointFiles[slot]);
+
+    if(!identity)
+        MPI_File_write_at(checkpointFiles[slot], 0, CHECKPOINT_FILE_MAGIC, sizeof(((struct checkpointHeader *)0)->magic), MPI_CHAR, MPI_STATUS_IGNORE);
+
+    MPI_File_sync(checkpointFiles[slot]);
+
+    free(checkpointHeaders[slot]);
+    checkpointHeaders[slot] = NULL;
+    checkpointPending[slot] = false;
+
+    if(!identity)
+    {
+        snprintf(fileName, sizeof(fileName), "%s.%d", checkpointFileName, slot);
+        printf("Checkpointed generation %d to %s\n", checkpointGenerationWritten[slot], fileName);
+    }
+
+    if(another)
+        blankCheckpoint(slot ^ 1);
+}
+
+/* Starts writing the board after some generation to the next checkpoint file, while the generations carry on. Every rank copies its cells
+   into a buffer of its own and writes them at once, and the master writes the header and block table alongside. None of it is waited on
+   until the next checkpoint, when finishCheckpoint() lands it */
+void startCheckpoint(int generation)
+{
+    struct checkpointHeader *header;
+    struct checkpointBlock *blocks;
+    MPI_Offset offset;
+    int slot;
+    int words;
+
+    slot = checkpointSlot;
+    checkpointSlot ^= 1;
+
+    if(!checkpointFilesOpen)
+        openCheckpointFiles();
+
+    //The last checkpoint has to be complete before this one starts overwriting the older one, and finishing it is what blanks the file this goes to
+    finishCheckpoint(slot ^ 1, true);
+    finishCheckpoint(slot, true);
+
+    //Only the first checkpoint finds its file still holding whatever an earlier run left there
+    if(!checkpointBlank[slot])
+        blankCheckpoint(slot);
+
+    //Every rank works out the same layout, so nobody has to wait for the table to find where its block goes. The table follows the header, and
+    //both stay around until they've been written
+    header = malloc(sizeof(struct checkpointHeader) + sizeof(struct checkpointBlock) * actualPartitions);
+    blocks = (struct checkpointBlock *)(header + 1);
+    offset = sizeof(struct checkpointHeader) + sizeof(struct checkpointBlock) * actualPartitions;
+
+    for(int i = 0; i < actualPartitions; i++)
+    {
+        blocks[i].startX = partitionArray[i].startX;
+        blocks[i].startY = partitionArray[i].startY;
+        blocks[i].lengthX = partitionArray[i].lengthX;
+        blocks[i].lengthY = partitionArray[i].lengthY;
+        blocks[i].offset = offset;
+
+        offset += sizeof(uint64_t) * packedEdgeWords(partitionArray[i].lengthX, partitionArray[i].lengthY);
+    }
+
+    //The header goes out with its magic still blank, so a checkpoint cut off partway is never mistaken for a complete one
+    checkpointHeaderRequests[slot] = MPI_REQUEST_NULL;
+
+    if(!identity)
+    {
+        memset(header, 0, sizeof(struct checkpointHeader));
+        header->version = CHECKPOINT_FILE_VERSION;
+        header->blocks = actualPartitions;
+        header->generation = generation;
+        header->generations = totalGenerations;
+        header->columns = masterBoard_columns;
+        header->rows = masterBoard_rows;
+        strcpy(header->rule, rule.name);
+
+        MPI_File_iwrite_at(checkpointFiles[slot], 0, header, sizeof(struct checkpointHeader) + sizeof(struct checkpointBlock) * actualPartitions, MPI_BYTE, &checkpointHeaderRequests[slot]);
+    }
+
+    words = 0;
+    offset = 0;
+
+    if(hasPartition)
+    {
+        words = packedEdgeWords(myCoords.lengthX, myCoords.lengthY);
+        offset = blocks[myPartition].offset;
+
+        if(checkpointBuffers[slot] == NULL)
+            checkpointBuffers[slot] = malloc(sizeof(uint64_t) * words);
+
+        if(engine == PACKED_ENGINE)
+            packRegion(localPackedBoard, localBoard_RowWords, haloDepth, haloDepth, myCoords.lengthX, myCoords.lengthY, checkpointBuffers[slot]);
+        else
+        {
+            memset(checkpointBuffers[slot], 0, sizeof(uint64_t) * words);
+
+            for(long k = 0; k < myCoords.lengthY; k++)
+                for(long j = 0; j < myCoords.lengthX; j++)
+                    if(getArray(j + haloDepth, k + haloDepth))
+                        checkpointBuffers[slot][(k * myCoords.lengthX + j) / CELLS_PER_WORD] |= (uint64_t)1 << ((k * myCoords.lengthX + j) % CELLS_PER_WORD);
+        }
+    }
+
+    MPI_File_iwrite_at_all(checkpointFiles[slot], offset, checkpointBuffers[slot], words, MPI_UINT64_T, &checkpointRequests[slot]);
+
+    checkpointHeaders[slot] = (char *)header;
+    checkpointPending[slot] = true;
+    checkpointBlank[slot] = false;
+    checkpointGenerationWritten[slot] = generation;
+}
+
+/* Lands whatever checkpoint is still being written and closes the files. The other file is left as it is, so the run ends with both of
+   its last checkpoints on disk */
+void finishCheckpoints()
+{
+    finishCheckpoint(checkpointSlot, false);
+    finishCheckpoint(checkpointSlot ^ 1, false);
+
+    if(checkpointPollPending)
+        MPI_Wait(&checkpointPollRequest, MPI_STATUS_IGNORE);
+
+    if(checkpointFilesOpen)
+    {
+        MPI_File_close(&checkpointFiles[0]);
+        MPI_File_close(&checkpointFiles[1]);
+        checkpointFilesOpen = false;
+    }
+
+    free(checkpointBuffers[0]);
+    free(checkpointBuffers[1]);
+}
+
+/* Hashes our cells twice in a way that doesn't depend on how the board is split: each live cell adds a hash of its place on the board,
+   once with each seed, so the whole board's hashes are the sums of every rank's */
+void hashPartition(uint64_t hash[2])
+{
+    uint64_t hash0;
+    uint64_t hash1;
+    int x1;
+
+    hash0 = 0;
+    hash1 = 0;
+    x1 = haloDepth + myCoords.lengthX - 1;
+
+    #pragma omp parallel for reduction(+:hash0, hash1) if((long)myCoords.lengthX * myCoords.lengthY >= PARALLEL_CELLS)
+    for(int j = 0; j < myCoords.lengthY; j++)
+    {
+        uint64_t rowStart = (uint64_t)(myCoords.startY + j) * masterBoard_columns + myCoords.startX - haloDepth;
+
+        if(engine == PACKED_ENGINE)
+        {
+            const uint64_t *row = localPackedBoard + (j + haloDepth) * localBoard_RowWords;
+
+            for(int w = haloDepth / CELLS_PER_WORD; w <= x1 / CELLS_PER_WORD; w++)
+                for(uint64_t bits = row[w] & packedWordMask(w, haloDepth, x1); bits != 0; bits &= bits - 1)
+                {
+                    hash0 += hashCell(CYCLE_HASH_SEED, rowStart + w * CELLS_PER_WORD + __builtin_ctzll(bits));
+                    hash1 += hashCell(CYCLE_CONFIRM_SEED, rowStart + w * CELLS_PER_WORD + __builtin_ctzll(bits));
+                }
+        }
+        else
+        {
+            const char *row = localBoard + (j + haloDepth) * localBoard_Width;
+
+            for(int i = haloDepth; i <= x1; i++)
+                if(row[i])
+                {
+                    hash0 += hashCell(CYCLE_HASH_SEED, rowStart + i);
+                    hash1 += hashCell(CYCLE_CONFIRM_SEED, rowStart + i);
+                }
+        }
+    }
+
+    hash[0] = hash0;
+    hash[1] = hash1;
+}
+
+/* Hashes the board after some generation and checks the hash started last time against the ones before it. Returns how many of the
+   generations left can be skipped once the board is found to repeat, which is as many whole cycles as there are left. Every rank
+   has to call it after the same generations */
+int detectCycle(int generation)
+{
+    int latest;
+    int period;
+    int skip;
+
+    if(cyclePending)
+    {
+        MPI_Wait(&cycleRequest, MPI_STATUS_IGNORE);
+        cyclePending = false;
+
+        //The most recent match gives the shortest cycle
+        latest = -1;
+
+        for(int i = 0; i < numberOfCycleHashes && i < cycleWindow; i++)
+            if(cycleHashes[2 * i] == cycleGlobalHash[0] && cycleHashes[2 * i + 1] == cycleGlobalHash[1] && (latest < 0 || cycleHashGenerations[i] > cycleHashGenerations[latest]))
+                latest = i;
+
+        if(latest >= 0)
+        {
+            period = cycleHashGeneration - cycleHashGenerations[latest];
+            skip = numberOfGenerations - numberOfGenerations % period;
+
+            if(!identity)
+                printf("The board after generation %d is the same as after generation %d, so it repeats every %d generations. Skipping the %d generations of whole cycles left\n",
+                       cycleHashGeneration, cycleHashGenerations[latest], period, skip);
+
+            //What's left is less than a cycle, so there's nothing more to find
+            cycleWindow = 0;
+
+            return skip;
+        }
+
+        cycleHashes[2 * (numberOfCycleHashes % cycleWindow)] = cycleGlobalHash[0];
+        cycleHashes[2 * (numberOfCycleHashes % cycleWindow) + 1] = cycleGlobalHash[1];
+        cycleHashGenerations[numberOfCycleHashes % cycleWindow] = cycleHashGeneration;
+        numberOfCycleHashes++;
+    }
+
+    hashPartition(cycleLocalHash);
+    cycleHashGeneration = generation;
+
+    MPI_Iallreduce(cycleLocalHash, cycleGlobalHash, 2, MPI_UINT64_T, MPI_SUM, boardComm, &cycleRequest);
+    cyclePending = true;
+
+    return 0;
+}
+
+/* Counts our live cells, and the births and deaths since the board in nextGenBoard, which is the generation before unless the last
+   few were run in one go, then finds the box around the live cells in board coordinates */
+void partitionStats(long long counts[3], int box[4])
+{
+    long long live;
+    long long births;
+    long long deaths;
+    int minX;
+    int minY;
+    int maxX;
+    int maxY;
+    int x1;
+
+    live = births = deaths = 0;
+    minX = minY = INT_MAX;
+    maxX = maxY = -1;
+    x1 = haloDepth + myCoords.lengthX - 1;
+
+    #pragma omp parallel for reduction(+:live, births, deaths) reduction(min:minX, minY) reduction(max:maxX, maxY) if((long)myCoords.lengthX * myCoords.lengthY >= PARALLEL_CELLS)
+    for(int j = haloDepth; j < haloDepth + myCoords.lengthY; j++)
+    {
+        int first = INT_MAX;
+        int last = -1;
+
+        if(engine == PACKED_ENGINE)
+        {
+            for(int w = haloDepth / CELLS_PER_WORD; w <= x1 / CELLS_PER_WORD; w++)
+            {
+                uint64_t mask = packedWordMask(w, haloDepth, x1);
+                uint64_t now = localPackedBoard[j * localBoard_RowWords + w] & mask;
+                uint64_t before = nextGenPackedBoard[j * localBoard_RowWords + w] & mask;
+
+                live += __builtin_popcountll(now);
+                births += __builtin_popcountll(now & ~before);
+                deaths += __builtin_popcountll(before & ~now);
+
+                if(now != 0)
+                {
+                    if(first == INT_MAX)
+                        first = w * CELLS_PER_WORD + __builtin_ctzll(now);
+
+                    last = w * CELLS_PER_WORD + CELLS_PER_WORD - 1 - __builtin_clzll(now);
+                }
+            }
+        }
+        else
+        {
+            const char *now = localBoard + j * localBoard_Width;
+            const char *before = nextGenBoard + j * localBoard_Width;
+
+            for(int i = haloDepth; i <= x1; i++)
+            {
+                live += now[i];
+                births += now[i] & !before[i];
+                deaths += before[i] & !now[i];
+
+                if(now[i])
+                {
+                    if(first == INT_MAX)
+                        first = i;
+
+                    last = i;
+                }
+            }
+        }
+
+        if(last >= 0)
+        {
+            minX = (first < minX) ? first : minX;
+            maxX = (last > maxX) ? last : maxX;
+            minY = (j < minY) ? j : minY;
+            maxY = (j > maxY) ? j : maxY;
+        }
+    }
+
+    counts[0] = live;
+    counts[1] = births;
+    counts[2] = deaths;
+
+    //An empty partition reduces to INT_MAX everywhere, which is left out of the box
+    box[0] = (maxX < 0) ? INT_MAX : myCoords.startX + minX - haloDepth;
+    box[1] = (maxX < 0) ? INT_MAX : myCoords.startY + minY - haloDepth;
+    box[2] = (maxX < 0) ? INT_MAX : -(myCoords.startX + maxX - haloDepth);
+    box[3] = (maxX < 0) ? INT_MAX : -(myCoords.startY + maxY - haloDepth);
+}
+
+/* Waits for the statistics in flight and has the master write them out */
+void finishStats()
+{
+    if(!statsPending)
+        return;
+
+    MPI_Waitall(2, statsRequests, MPI_STATUSES_IGNORE);
+    statsPending = false;
+
+    if(!identity)
+    {
+        if(statsBoxes[0] == INT_MAX)
+            fprintf(statsFile, "%d,%lld,%lld,%lld,,,,\n", statsGeneration, statsTotals[0], statsTotals[1], statsTotals[2]);
+        else
+            fprintf(statsFile, "%d,%lld,%lld,%lld,%d,%d,%d,%d\n", statsGeneration, statsTotals[0], statsTotals[1], statsTotals[2],
+                    statsBoxes[0], statsBoxes[1], -statsBoxes[2], -statsBoxes[3]);
+    }
+}
+
+/* Takes the statistics after some generation, writing out the last ones first. Every rank has to call it after the same generations */
+void takeStats(int generation)
+{
+    finishStats();
+
+    partitionStats(statsCounts, statsBox);
+    statsGeneration = generation;
+
+    MPI_Ireduce(statsCounts, statsTotals, 3, MPI_LONG_LONG, MPI_SUM, 0, boardComm, &statsRequests[0]);
+    MPI_Ireduce(statsBox, statsBoxes, 4, MPI_INT, MPI_MIN, 0, boardComm, &statsRequests[1]);
+    statsPending = true;
+}
+
+/* Spreads some amount of work evenly over a rectangle of the local board, adding it to the work of the board's columns and rows */
+void spreadWork(int x0, int y0, int x1, int y1, double work, double *columnWork, double *rowWork)
+{
+    if(x0 > x1 || y0 > y1)
+        return;
+
+    for(int x = x0; x <= x1; x++)
+        columnWork[myCoords.startX + x - haloDepth] += work / (x1 - x0 + 1);
+
+    for(int y = y0; y <= y1; y++)
+        rowWork[myCoords.startY + y - haloDepth] += work / (y1 - y0 + 1);
+}
+
+/* Cuts a line of length columns (or rows), each with some work, into pieces with about the same work each, none narrower than minimum.
+   Fills in where each piece starts, and where the last one ends */
+void divideWork(const double *work, int length, int pieces, int minimum, int *starts)
+{
+    double *total;
+    int x;
+
+    //total[x] is the work of everything before x
+    total = malloc(sizeof(double) * (length + 1));
+    total[0] = 0;
+
+    for(int i = 0; i < length; i++)
+        total[i + 1] = total[i] + work[i];
+
+    starts[0] = 0;
+    starts[pieces] = length;
+    x = 0;
+
+    for(int i = 1; i < pieces; i++)
+    {
+        double target = total[length] * i / pieces;
+
+        //Cuts where the work so far comes closest to its share
+        while(x < length && total[x + 1] <= target)
+            x++;
+
+        if(x < length && total[x + 1] - target < target - total[x])
+            x++;
+
+        if(x < starts[i - 1] + minimum)
+            x = starts[i - 1] + minimum;
+        if(x > length - (pieces - i) * minimum)
+            x = length - (pieces - i) * minimum;
+
+        starts[i] = x;
+    }
+
+    free(total);
+}
+
+/* Finds the part of a partition's rectangle that's also in another, returning false if there isn't any */
+bool overlapPartitions(const struct partition *a, const struct partition *b, struct partition *overlap)
+{
+    overlap->startX = (a->startX > b->startX) ? a->startX : b->startX;
+    overlap->startY = (a->startY > b->startY) ? a->startY : b->startY;
+    overlap->lengthX = ((a->startX + a->lengthX < b->startX + b->lengthX) ? a->startX + a->lengthX : b->startX + b->lengthX) - overlap->startX;
+    overlap->lengthY = ((a->startY + a->lengthY < b->startY + b->lengthY) ? a->startY + a->lengthY : b->startY + b->lengthY) - overlap->startY;
+
+    return overlap->lengthX > 0 && overlap->lengthY > 0;
+}
+
+/* Describes where part of the board sits in a padded char board holding some partition */
+MPI_Datatype overlapType(const struct partition *overlap, const struct partition *board)
+{
+    int sizes[2] = {board->lengthY + 2 * haloDepth, board->lengthX + 2 * haloDepth};
+    int subsizes[2] = {overlap->lengthY, overlap->lengthX};
+    int starts[2] = {overlap->startY - board->startY + haloDepth, overlap->startX - board->startX + haloDepth};
+    MPI_Datatype type;
+
+    MPI_Type_create_subarray(2, sizes, subsizes, starts, MPI_ORDER_C, MPI_CHAR, &type);
+    MPI_Type_commit(&type);
+
+    return type;
+}
+
+/* Moves the partition boundaries so every rank gets about the same share of the measured work, then hands the cells over to their new
+   owners with one MPI_Alltoallw. The partitions stay a grid of the same shape, so every rank keeps its neighbors and the halo exchange
+   only has to be rebuilt for the new sizes. Only happens right before an exchange, when the whole of every partition is current */
+void rebalanceBoard(int generation)
+{
+    int numberOfProcessors;
+    int *columnStarts;
+    int *rowStarts;
+    int *heldPartitions;
+    int *sendCounts;
+    int *recvCounts;
+    int *displacements;
+    double busiest;
+    double average;
+    double *columnWork;
+    double *rowWork;
+    char *oldCells;
+    char *newCells;
+    struct partition *oldPartitions;
+    struct partition oldCoords;
+    struct partition overlap;
+    MPI_Datatype *sendTypes;
+    MPI_Datatype *recvTypes;
+
+    MPI_Comm_size(boardComm, &numberOfProcessors);
+
+    MPI_Allreduce(&computeSeconds, &busiest, 1, MPI_DOUBLE, MPI_MAX, boardComm);
+    MPI_Allreduce(&computeSeconds, &average, 1, MPI_DOUBLE, MPI_SUM, boardComm);
+    average /= actualPartitions;
+
+    if(busiest <= REBALANCE_THRESHOLD * average)
+    {
+        computeSeconds = 0;
+
+        if(tileSize > 0 && hasPartition)
+            memset(tileWork, 0, sizeof(int) * tilesX * tilesY);
+
+        return;
+    }
+
+    //Each rank's time is spread over its cells, by how often each tile was computed when there are tiles
+    columnWork = calloc(masterBoard_columns, sizeof(double));
+    rowWork = calloc(masterBoard_rows, sizeof(double));
+
+    if(hasPartition)
+    {
+        double totalWork = 0;
+
+        for(int t = 0; tileSize > 0 && t < tilesX * tilesY; t++)
+            totalWork += tileWork[t];
+
+        if(totalWork > 0)
+        {
+            for(int t = 0; t < tilesX * tilesY; t++)
+            {
+                int x0 = (t % tilesX) * tileSize;
+                int y0 = (t / tilesX) * tileSize;
+                int x1 = x0 + tileSize - 1;
+                int y1 = y0 + tileSize - 1;
+
+                spreadWork(x0 > haloDepth ? x0 : haloDepth, y0 > haloDepth ? y0 : haloDepth,
+                           x1 < haloDepth + myCoords.lengthX - 1 ? x1 : haloDepth + myCoords.lengthX - 1,
+                           y1 < haloDepth + myCoords.lengthY - 1 ? y1 : haloDepth + myCoords.lengthY - 1,
+                           computeSeconds * tileWork[t] / totalWork, columnWork, rowWork);
+            }
+
+            memset(tileWork, 0, sizeof(int) * tilesX * tilesY);
+        }
+        else
+            spreadWork(haloDepth, haloDepth, haloDepth + myCoords.lengthX - 1, haloDepth + myCoords.lengthY - 1, computeSeconds, columnWork, rowWork);
+    }
+
+    computeSeconds = 0;
+
+    MPI_Allreduce(MPI_IN_PLACE, columnWork, masterBoard_columns, MPI_DOUBLE, MPI_SUM, boardComm);
+    MPI_Allreduce(MPI_IN_PLACE, rowWork, masterBoard_rows, MPI_DOUBLE, MPI_SUM, boardComm);
+
+    //Everyone has the same work to go by, so everyone comes up with the same boundaries. Nothing gets thinner than the halo
+    columnStarts = malloc(sizeof(int) * (partitionsX + 1));
+    rowStarts = malloc(sizeof(int) * (partitionsY + 1));
+    divideWork(columnWork, masterBoard_columns, partitionsX, haloDepth, columnStarts);
+    divideWork(rowWork, masterBoard_rows, partitionsY, haloDepth, rowStarts);
+
+    free(columnWork);
+    free(rowWork);
+
+    oldPartitions = malloc(sizeof(struct partition) * actualPartitions);
+    memcpy(oldPartitions, partitionArray, sizeof(struct partition) * actualPartitions);
+
+    for(int i = 0; i < actualPartitions; i++)
+    {
+        partitionArray[i].startX = columnStarts[i % partitionsX];
+        partitionArray[i].lengthX = columnStarts[i % partitionsX + 1] - columnStarts[i % partitionsX];
+        partitionArray[i].startY = rowStarts[i / partitionsX];
+        partitionArray[i].lengthY = rowStarts[i / partitionsX + 1] - rowStarts[i / partitionsX];
+    }
+
+    free(columnStarts);
+    free(rowStarts);
+
+    if(memcmp(oldPartitions, partitionArray, sizeof(struct partition) * actualPartitions) == 0)
+    {
+        free(oldPartitions);
+        return;
+    }
+
+    if(!identity)
+        printf("Rebalancing after generation %d, the busiest rank was computing %.0f%% more than the average\n", generation, 100 * (busiest / average - 1));
+
+    //Checkpoints still being written are using buffers the size of the old partitions
+    if(checkpointFileName != NULL)
+    {
+        finishCheckpoint(checkpointSlot, true);
+        finishCheckpoint(checkpointSlot ^ 1, true);
+
+        free(checkpointBuffers[0]);
+        free(checkpointBuffers[1]);
+        checkpointBuffers[0] = NULL;
+        checkpointBuffers[1] = NULL;
+    }
+
+    heldPartitions = malloc(sizeof(int) * numberOfProcessors);
+    MPI_Allgather(&myPartition, 1, MPI_INT, heldPartitions, 1, MPI_INT, boardComm);
+
+    oldCells = NULL;
+    newCells = NULL;
+
+    if(hasPartition)
+    {
+        freeHaloExchange();
+        freeTiles();
+
+        //Cells move around as chars, packed boards are unpacked for it. They're copied out of the boards either way, since those are
+        //reallocated for the new partition before the cells arrive
+        oldCells = malloc(sizeof(char) * localBoard_Size);
+
+        if(engine == PACKED_ENGINE)
+        {
+            for(int k = 0; k < localBoard_Height; k++)
+                unpackRow(localPackedBoard + k * localBoard_RowWords, localBoard_Width, oldCells + k * localBoard_Width);
+        }
+        else
+            memcpy(oldCells, localBoard, sizeof(char) * localBoard_Size);
+
+        freeBoards();
+
+        oldCoords = myCoords;
+        myCoords = partitionArray[myPartition];
+
+        localBoard_Width = myCoords.lengthX + 2 * haloDepth;
+        localBoard_Height = myCoords.lengthY + 2 * haloDepth;
+        localBoard_Size = localBoard_Width * localBoard_Height;
+
+        //Ghost cells at the edge of the board have to start out dead, the rest come in with the next exchange
+        allocateBoards();
+        newCells = partitionCells();
+    }
+
+    sendCounts = calloc(numberOfProcessors, sizeof(int));
+    recvCounts = calloc(numberOfProcessors, sizeof(int));
+    displacements = calloc(numberOfProcessors, sizeof(int));
+    sendTypes = malloc(sizeof(MPI_Datatype) * numberOfProcessors);
+    recvTypes = malloc(sizeof(MPI_Datatype) * numberOfProcessors);
+
+    for(int r = 0; r < numberOfProcessors; r++)
+    {
+        sendTypes[r] = MPI_CHAR;
+        recvTypes[r] = MPI_CHAR;
+
+        if(!hasPartition || heldPartitions[r] < 0)
+            continue;
+
+        //What we had that's theirs now, and what they had that's ours now
+        if(overlapPartitions(&oldCoords, &partitionArray[heldPartitions[r]], &overlap))
+        {
+            sendTypes[r] = overlapType(&overlap, &oldCoords);
+            sendCounts[r] = 1;
+        }
+
+        if(overlapPartitions(&oldPartitions[heldPartitions[r]], &myCoords, &overlap))
+        {
+            recvTypes[r] = overlapType(&overlap, &myCoords);
+            recvCounts[r] = 1;
+        }
+    }
+
+    MPI_Alltoallw(oldCells, sendCounts, displacements, sendTypes, newCells, recvCounts, displacements, recvTypes, boardComm);
+
+    for(int r = 0; r < numberOfProcessors; r++)
+    {
+        if(sendCounts[r])
+            MPI_Type_free(&sendTypes[r]);
+        if(recvCounts[r])
+            MPI_Type_free(&recvTypes[r]);
+    }
+
+    if(hasPartition)
+    {
+        free(oldCells);
+
+        storePartition(newCells);
+
+        setupTiles();
+        setupHaloExchange();
+    }
+
+    free(sendCounts);
+    free(recvCounts);
+    free(displacements);
+    free(sendTypes);
+    free(recvTypes);
+    free(heldPartitions);
+    free(oldPartitions);
+}
+
+/* Runs every generation at once with the hashlife engine. The board is gathered onto the master, which does all the work, then handed
+   back out so it's finished off the same way as with any other engine */
+void calculateHashlife()
+{
+    gatherBoard();
+
+    if(!identity)
+        runHashlife(masterBoard, masterBoard_columns, masterBoard_rows, numberOfGenerations, (size_t)hashlifeMegabytes << 20, rule.birth, rule.survival);
+
+    scatterBoard();
+
+    numberOfGenerations = 0;
+}
+
+/* Updates the board */
+void calculateBoard()
+{
+    int step;
+    int x0;
+    int y0;
+    int x1;
+    int y1;
+    int innerX0;    //Our cells that don't depend on the ghost region
+    int innerY0;
+    int innerX1;
+    int innerY1;
+    int generations;    //Generations run this time round
+    int generationsRun;
+    int nextBalance;
+    int nextCycleHash;
+    int nextStats;
+    bool checkpointNow;
+    double start;
+
+    step = 0;
+    generationsRun = 0;
+    nextBalance = balanceGenerations;
+    nextCycleHash = 0;
+    nextStats = statsGenerations;
+    computeSeconds = 0;
+    generationsToRun = numberOfGenerations;
+
+    //Everyone starts the clock together, the barrier at the end stops it
+    MPI_Barrier(boardComm);
+    runSeconds = MPI_Wtime();
+    lastCheckpointTime = runSeconds;
+
+    if(statsFileName != NULL)
+    {
+        statsPending = false;
+
+        //A new log gets a header, an old one is carried on from where it was
+        if(!identity)
+        {
+            statsFile = fopen(statsFileName, "a");
+
+            if(statsFile == NULL)
+            {
+                printf("Could not create %s\n", statsFileName);
+                exit(1);
+            }
+
+            if(ftell(statsFile) == 0)
+                fprintf(statsFile, "generation,live,births,deaths,minX,minY,maxX,maxY\n");
+        }
+    }
+
+    if(cycleWindow > 0)
+    {
+        cycleHashes = malloc(sizeof(uint64_t) * 2 * cycleWindow);
+        cycleHashGenerations = malloc(sizeof(int) * cycleWindow);
+        numberOfCycleHashes = 0;
+        cyclePending = false;
+    }
+
+    if(engine == HASHLIFE_ENGINE)
+    {
+        TIMING_START(TIMING_HASHLIFE);
+        calculateHashlife();
+        TIMING_STOP(TIMING_HASHLIFE);
+    }
+
+    while(numberOfGenerations > 0)
+    {
+        generations = 1;
+
+        TIMING_GENERATION(totalGenerations - numberOfGenerations);
+
+        if(hasPartition)//If we are a board doing work
+        {
+            if(temporalBlocking)
+            {
+                //A whole exchange's worth of generations in one go, tile by tile
+                generations = (numberOfGenerations < haloGenerations) ? numberOfGenerations : haloGenerations;
+
+                startHaloExchange();
+
+                TIMING_START(TIMING_COMPUTE);
+                start = MPI_Wtime();
+                calculateTiles(generations, false);
+                computeSeconds += MPI_Wtime() - start;
+                TIMING_STOP(TIMING_COMPUTE);
+
+                finishHaloExchange();
+
+                TIMING_START(TIMING_COMPUTE_EDGE);
+                start = MPI_Wtime();
+                calculateTiles(generations, true);
+                computeSeconds += MPI_Wtime() - start;
+                TIMING_STOP(TIMING_COMPUTE_EDGE);
+
+                TIMING_START(TIMING_SWAP);
+                swapBoards();
+                TIMING_STOP(TIMING_SWAP);
+            }
+            else
+            {
+                //Right after an exchange the whole padded board is current. Each generation after that the valid part shrinks by the rule's
+                //radius on every side with a neighbor, until haloGenerations generations later it's time to exchange again.
+                //Sides at the edge of the board never shrink, their ghost cells just stay dead
+                x0 = (myNeighborIDs[3] > -1) ? (step + 1) * rule.radius : haloDepth;
+                y0 = (myNeighborIDs[1] > -1) ? (step + 1) * rule.radius : haloDepth;
+                x1 = (myNeighborIDs[4] > -1) ? localBoard_Width - 1 - (step + 1) * rule.radius : haloDepth + myCoords.lengthX - 1;
+                y1 = (myNeighborIDs[6] > -1) ? localBoard_Height - 1 - (step + 1) * rule.radius : haloDepth + myCoords.lengthY - 1;
+
+                if(step == 0)
+                {
+                    startHaloExchange();
+
+                    //Cells further from the ghost region than the rule reaches don't need anything from the neighbors, so they're done while the edges are in flight
+                    innerX0 = haloDepth + rule.radius;
+                    innerY0 = haloDepth + rule.radius;
+                    innerX1 = haloDepth + myCoords.lengthX - 1 - rule.radius;
+                    innerY1 = haloDepth + myCoords.lengthY - 1 - rule.radius;
+
+                    TIMING_START(TIMING_COMPUTE);
+                    start = MPI_Wtime();
+                    calculateRegion(innerX0, innerY0, innerX1, innerY1, false);
+                    computeSeconds += MPI_Wtime() - start;
+                    TIMING_STOP(TIMING_COMPUTE);
+
+                    finishHaloExchange();
+
+                    //Deep ghost cells were just received rather than computed from the other buffer, so tiles can't vouch for them and they're all computed
+                    TIMING_START(TIMING_COMPUTE_EDGE);
+                    start = MPI_Wtime();
+                    calculateRing(x0, y0, x1, y1, innerX0, innerY0, innerX1, innerY1, haloGenerations > 1);
+                    computeSeconds += MPI_Wtime() - start;
+                    TIMING_STOP(TIMING_COMPUTE_EDGE);
+                }
+                else
+                {
+                    TIMING_START(TIMING_COMPUTE);
+                    start = MPI_Wtime();
+                    calculateRegion(x0, y0, x1, y1, false);
+                    computeSeconds += MPI_Wtime() - start;
+                    TIMING_STOP(TIMING_COMPUTE);
+                }
+
+                TIMING_START(TIMING_SWAP);
+                swapBoards();
+                TIMING_STOP(TIMING_SWAP);
+
+                step = (step + 1) % haloGenerations;
+            }
+        }
+
+        //No barrier here, waiting on the neighbors' edges is enough to keep everyone in step
+
+        //Checkpoints can only be taken once the generations just run are all done, but every generation still counts towards deciding on one
+        checkpointNow = false;
+
+        for(int g = 0; g < generations; g++)
+        {
+            numberOfGenerations--;
+            generationsRun++;
+
+            if(checkpointFileName != NULL && checkpointDue(totalGenerations - numberOfGenerations))
+                checkpointNow = true;
+        }
+
+        //With temporal blocking several generations go by at once, so births and deaths are since the one before those
+        if(statsFileName != NULL && generationsRun >= nextStats)
+        {
+            takeStats(totalGenerations - numberOfGenerations);
+            nextStats = generationsRun + statsGenerations;
+        }
+
+        //Skipping whole cycles moves the generation on, so a checkpoint after it still records where the board really is
+        if(cycleWindow > 0 && generationsRun >= nextCycleHash)
+        {
+            numberOfGenerations -= detectCycle(totalGenerations - numberOfGenerations);
+            nextCycleHash = generationsRun + cycleGenerations;
+        }
+
+        //Everyone counts the same generations, so everyone comes here together. It has to be right before an exchange
+        if(balanceGenerations > 0 && generationsRun >= nextBalance && generationsRun % haloGenerations == 0 && numberOfGenerations > 0)
+        {
+            TIMING_START(TIMING_REBALANCE);
+            rebalanceBoard(totalGenerations - numberOfGenerations);
+            TIMING_STOP(TIMING_REBALANCE);
+            nextBalance = generationsRun + balanceGenerations;
+        }
+
+        //Checkpoints are taken between generations, by everyone at once
+        if(checkpointNow)
+        {
+            TIMING_START(TIMING_CHECKPOINT);
+            startCheckpoint(totalGenerations - numberOfGenerations);
+            TIMING_STOP(TIMING_CHECKPOINT);
+        }
+    }
+
+    TIMING_GENERATION(-1);
+
+    if(cyclePending)
+    {
+        MPI_Wait(&cycleRequest, MPI_STATUS_IGNORE);
+        cyclePending = false;
+    }
+
+    if(statsFileName != NULL)
+    {
+        finishStats();
+
+        if(!identity)
+            fclose(statsFile);
+    }
+
+    if(cycleHashes != NULL)
+    {
+        free(cycleHashes);
+        free(cycleHashGenerations);
+        cycleHashes = NULL;
+        cycleHashGenerations = NULL;
+    }
+
+    if(checkpointFileName != NULL)
+    {
+        TIMING_START(TIMING_CHECKPOINT);
+        finishCheckpoints();
+        TIMING_STOP(TIMING_CHECKPOINT);
+    }
+
+    TIMING_START(TIMING_BARRIER);
+    MPI_Barrier(boardComm); //Wait here after all generations are done
+    TIMING_STOP(TIMING_BARRIER);
+
+    runSeconds = MPI_Wtime() - runSeconds;
+
+    if(hasPartition)
+    {
+        freeHaloExchange();
+        freeTiles();
+    }
+}
+
+/* Determines if some cell of a board (the local one, or a scratch copy of part of it) is alive or dead in the next generation, by a radius 1 rule */
+bool isAlive(const char *board, int width, int height, int x, int y)
+{
+    int numNeighbors;
+
+    numNeighbors = 0;
+
+    for(int j = -1; j <= 1; j++)
+        for(int i = -1; i <= 1; i++)
+        {
+            if(!(((x + i) < 0) || ((x + i) >= width) || ((y + j) < 0) || ((y + j) >= height) || (i == 0 && j == 0)))//If the cell is in-bounds
+                numNeighbors += board[(x + i) + (y + j) * width];
+        }
+
+    //Bit n of each mask says whether a cell with n neighbors lives, so the rule is a single test
+    return ((board[x + y * width] ? rule.survival : rule.birth) >> numNeighbors) & 1;
+}
+
+//Swaps the current gen board with the next gen board to save from mallocing tons of boards
+void swapBoards(void)
+{
+    char* tempBoard;
+    uint64_t* tempPackedBoard;
+
+    tempBoard = localBoard;
+    localBoard = nextGenBoard;
+    nextGenBoard = tempBoard;
+
+    currentBoard ^= 1;
+
+    tempPackedBoard = localPackedBoard;
+    localPackedBoard = nextGenPackedBoard;
+    nextGenPackedBoard = tempPackedBoard;
+
+    //The next generation goes into the board the neighbors on our node last read from
+    finishSharedReads();
+
+    //What changed this generation is what the next one has to look at
+    if(tileSize > 0)
+    {
+        unsigned char *tempTiles = tileChanged;
+        tileChanged = nextTileChanged;
+        nextTileChanged = tempTiles;
+
+        memset(nextTileChanged, 0, sizeof(unsigned char) * tilesX * tilesY);
+        changedTiles = nextChangedTiles;
+        nextChangedTiles = 0;
+    }
+}
+
+void initMPI(int argc, char ** argv)
+{
+    int threadSupport;
+
+    //Threads only ever compute, every MPI call is made from the main thread
+    MPI_Init_thread(&argc, &argv, MPI_THREAD_FUNNELED, &threadSupport);
+    MPI_Comm_rank(MPI_COMM_WORLD, &identity);
+
+    parseOptions(argc, argv);
+
+    TIMING_INIT(traceFileName != NULL);
+
+#ifdef _OPENMP
+    if(threadsPerRank > 0)
+        omp_set_num_threads(threadsPerRank);
+
+    if(threadSupport < MPI_THREAD_FUNNELED && threadCount() > 1)
+    {
+        if(!identity)
+            printf("This MPI can't be used with threads, running one thread per rank\n");
+
+        omp_set_num_threads(1);
+    }
+#endif
+
+    if(!identity && !quiet)
+        printf("Running %d threads per rank\n", threadCount());
+
+    numberOfMemoryAllocations = 0;//Used for our garbage collection stuff
+    allocatedMemory = malloc(sizeof(char*) * 8);
+
+    initializeBoard();
+}
+
+void main(int argc, char ** argv)
+{
+    initMPI(argc, argv);
+
+    //Ranks left without a partition are done once the board is loaded
+    if(hasPartition)
+    {
+        calculateBoard();
+
+        finalizeBoard();
+
+        TIMING_REPORT(boardComm, traceFileName);
+
+        freeBoards();
+    }
+
+    MPI_Finalize();//Godbye world!
 }
 
@@ -0,0 +1,245 @@
+#include "PackedBoard.h"
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "Rule.h"
+
+//Packed storage for the local board
+//Each row of the padded board is stored as a run of 64 bit words, bit i of word w holding the cell at x = 64w + i
+//Rows are padded out to a whole number of words so every row starts on a word boundary
+
+//Regions smaller than this many cells are updated by a single thread (a word covers 64 of them, so the bar is higher than for chars)
+#define PARALLEL_CELLS 131072
+
+/* Returns the number of words needed to hold a row of some width */
+int packedRowWords(int width)
+{
+    return (width + CELLS_PER_WORD - 1) / CELLS_PER_WORD;
+}
+
+/* Packs a row of one-char-per-cell values into words. Unused bits in the last word are cleared */
+void packRow(const char *cells, int width, uint64_t *row)
+{
+    int words;
+
+    words = packedRowWords(width);
+
+    memset(row, 0, sizeof(uint64_t) * words);
+
+    for(int i = 0; i < width; i++)
+        if(cells[i])
+            row[i / CELLS_PER_WORD] |= (uint64_t)1 << (i % CELLS_PER_WORD);
+}
+
+/* Expands a packed row back into one char per cell */
+void unpackRow(const uint64_t *row, int width, char *cells)
+{
+    for(int i = 0; i < width; i++)
+        cells[i] = (row[i / CELLS_PER_WORD] >> (i % CELLS_PER_WORD)) & 1;
+}
+
+/* Treats the packed board as if it's a two dimensional array */
+int getPackedCell(const uint64_t *board, int rowWords, int x, int y)
+{
+    return (board[y * rowWords + x / CELLS_PER_WORD] >> (x % CELLS_PER_WORD)) & 1;
+}
+
+void setPackedCell(uint64_t *board, int rowWords, int x, int y, int value)
+{
+    uint64_t bit;
+
+    bit = (uint64_t)1 << (x % CELLS_PER_WORD);
+
+    if(value)
+        board[y * rowWords + x / CELLS_PER_WORD] |= bit;
+    else
+        board[y * rowWords + x / CELLS_PER_WORD] &= ~bit;
+}
+
+/* Copies a rectangle of the packed board into a contiguous bit stream (row by row). Returns the number of words written */
+int packRegion(const uint64_t *board, int rowWords, int x, int y, int width, int height, uint64_t *buffer)
+{
+    int words;
+    long bit;
+
+    words = (int)(((long)width * height + CELLS_PER_WORD - 1) / CELLS_PER_WORD);
+    memset(buffer, 0, sizeof(uint64_t) * words);
+
+    bit = 0;
+
+    for(int j = 0; j < height; j++)
+        for(int i = 0; i < width; i++, bit++)
+            if(getPackedCell(board, rowWords, x + i, y + j))
+                buffer[bit / CELLS_PER_WORD] |= (uint64_t)1 << (bit % CELLS_PER_WORD);
+
+    return words;
+}
+
+/* Writes a bit stream produced by packRegion back into a rectangle of the packed board */
+void unpackRegion(uint64_t *board, int rowWords, int x, int y, int width, int height, const uint64_t *buffer)
+{
+    long bit;
+
+    bit = 0;
+
+    for(int j = 0; j < height; j++)
+        for(int i = 0; i < width; i++, bit++)
+            setPackedCell(board, rowWords, x + i, y + j, (buffer[bit / CELLS_PER_WORD] >> (bit % CELLS_PER_WORD)) & 1);
+}
+
+/* Adds three one bit values for 64 cells at a time */
+static inline void fullAdder(uint64_t a, uint64_t b, uint64_t c, uint64_t *sum, uint64_t *carry)
+{
+    uint64_t partial;
+
+    partial = a ^ b;
+    *sum = partial ^ c;
+    *carry = (a & b) | (partial & c);
+}
+
+/* Which of 64 cells live, from the bits of their four bit neighbor counts and whether they're alive now, by the rule's masks of the
+   counts a cell is born and survives with. Each count the rule does something with is matched bit by bit, so with constant masks
+   only those are built. B3/S23 gets the shortcut of matching 2 or 3 at once */
+static inline __attribute__((always_inline)) uint64_t cellsLive(uint64_t ones, uint64_t twos, uint64_t fours, uint64_t eights, uint64_t c, uint32_t birth, uint32_t survival)
+{
+    uint64_t result;
+
+    //A cell lives with exactly three neighbors, or with two if it's already alive
+    if(birth == LIFE_BIRTH && survival == LIFE_SURVIVAL)
+        return twos & ~fours & ~eights & (ones | c);
+
+    result = 0;
+
+    #pragma GCC unroll 9
+    for(int n = 0; n <= 8; n++)
+    {
+        bool born = (birth >> n) & 1;
+        bool stays = (survival >> n) & 1;
+        uint64_t match;
+
+        if(!born && !stays)
+            continue;
+
+        match = ((n & 1) ? ones : ~ones) & ((n & 2) ? twos : ~twos) & ((n & 4) ? fours : ~fours) & ((n & 8) ? eights : ~eights);
+
+        if(born && stays)
+            result |= match;
+        else if(born)
+            result |= match & ~c;
+        else
+            result |= match & c;
+    }
+
+    return result;
+}
+
+/* Updates the cells x0 to x1 of rows y0 to y1 of a packed board, 64 cells per word, by a rule. Every other bit of nextBoard is left alone */
+static inline __attribute__((always_inline)) void calculatePackedRule(const uint64_t *board, uint64_t *nextBoard, int rowWords, int x0, int y0, int x1, int y1,
+                                                                      uint32_t birth, uint32_t survival)
+{
+    //Rows are independent, so threads split them when there's enough work to go around
+    #pragma omp parallel for if((long)(x1 - x0 + 1) * (y1 - y0 + 1) >= PARALLEL_CELLS)
+    for(int y = y0; y <= y1; y++)
+    {
+        const uint64_t *above = board + (y - 1) * rowWords;
+        const uint64_t *middle = board + y * rowWords;
+        const uint64_t *below = board + (y + 1) * rowWords;
+        uint64_t *out = nextBoard + y * rowWords;
+
+        for(int w = x0 / CELLS_PER_WORD; w <= x1 / CELLS_PER_WORD; w++)
+        {
+            uint64_t n, nw, ne, c, cw, ce, s, sw, se;
+            uint64_t sumA, carryA, sumB, carryB, sumC, carryC;
+            uint64_t ones, carryOnes, twos, carryTwos, carryFours, fours, eights;
+            uint64_t result;
+            uint64_t mask;
+            int firstBit;
+            int lastBit;
+
+            //Neighbors to the west and east of each bit come from shifting in the edge bits of the adjacent words
+            n = above[w];
+            nw = (n << 1) | (w > 0 ? above[w - 1] >> 63 : 0);
+            ne = (n >> 1) | (w < rowWords - 1 ? above[w + 1] << 63 : 0);
+
+            c = middle[w];
+            cw = (c << 1) | (w > 0 ? middle[w - 1] >> 63 : 0);
+            ce = (c >> 1) | (w < rowWords - 1 ? middle[w + 1] << 63 : 0);
+
+            s = below[w];
+            sw = (s << 1) | (w > 0 ? below[w - 1] >> 63 : 0);
+            se = (s >> 1) | (w < rowWords - 1 ? below[w + 1] << 63 : 0);
+
+            //Bit-sliced sum of the eight neighbors, giving a four bit count per cell
+            fullAdder(nw, n, ne, &sumA, &carryA);
+            fullAdder(cw, ce, sw, &sumB, &carryB);
+            sumC = s ^ se;
+            carryC = s & se;
+
+            fullAdder(sumA, sumB, sumC, &ones, &carryOnes);
+            fullAdder(carryA, carryB, carryC, &twos, &carryTwos);
+
+            carryFours = twos & carryOnes;
+            twos ^= carryOnes;
+            fours = carryTwos ^ carryFours;
+            eights = carryTwos & carryFours;
+
+            result = cellsLive(ones, twos, fours, eights, c, birth, survival);
+
+            //Only cells x0 through x1 are being updated
+            firstBit = w * CELLS_PER_WORD;
+            lastBit = firstBit + CELLS_PER_WORD - 1;
+            mask = ~(uint64_t)0;
+
+            if(firstBit < x0)
+                mask &= ~(uint64_t)0 << (x0 - firstBit);
+            if(lastBit > x1)
+                mask &= ~(uint64_t)0 >> (lastBit - x1);
+
+            out[w] = (result & mask) | (out[w] & ~mask);
+        }
+    }
+}
+
+//The rule the kernel built for any rule checks against
+static uint32_t anyBirth;
+static uint32_t anySurvival;
+
+//Each common rule gets a kernel of its own with the rule's masks built in, and any other rule goes through the one that checks the masks as it goes
+#define RULE_KERNEL(name, birth, survival) \
+    static void calculatePacked##name(const uint64_t *board, uint64_t *nextBoard, int rowWords, int x0, int y0, int x1, int y1) \
+    { \
+        calculatePackedRule(board, nextBoard, rowWords, x0, y0, x1, y1, birth, survival); \
+    }
+
+RULE_KERNEL(Life, LIFE_BIRTH, LIFE_SURVIVAL)
+RULE_KERNEL(HighLife, HIGHLIFE_BIRTH, HIGHLIFE_SURVIVAL)
+RULE_KERNEL(DayAndNight, DAY_AND_NIGHT_BIRTH, DAY_AND_NIGHT_SURVIVAL)
+RULE_KERNEL(AnyRule, anyBirth, anySurvival)
+
+typedef void (*packedKernel)(const uint64_t *board, uint64_t *nextBoard, int rowWords, int x0, int y0, int x1, int y1);
+
+static packedKernel ruleKernel = calculatePackedLife;
+
+/* Picks the kernel for a rule's masks of the neighbor counts a cell is born and survives with. B3/S23 until this is called */
+void initPackedKernel(uint32_t birth, uint32_t survival)
+{
+    anyBirth = birth;
+    anySurvival = survival;
+
+    if(birth == LIFE_BIRTH && survival == LIFE_SURVIVAL)
+        ruleKernel = calculatePackedLife;
+    else if(birth == HIGHLIFE_BIRTH && survival == HIGHLIFE_SURVIVAL)
+        ruleKernel = calculatePackedHighLife;
+    else if(birth == DAY_AND_NIGHT_BIRTH && survival == DAY_AND_NIGHT_SURVIVAL)
+        ruleKernel = calculatePackedDayAndNight;
+    else
+        ruleKernel = calculatePackedAnyRule;
+}
+
+/* Updates the cells x0 to x1 of rows y0 to y1 of a packed board, 64 cells per word. Every other bit of nextBoard is left alone */
+void calculatePackedBoard(const uint64_t *board, uint64_t *nextBoard, int rowWords, int x0, int y0, int x1, int y1)
+{
+    ruleKernel(board, nextBoard, rowWords, x0, y0, x1, y1);
+}
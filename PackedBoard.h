@@ -0,0 +1,27 @@
+#ifndef PACKEDBOARD_H_INCLUDED
+#define PACKEDBOARD_H_INCLUDED
+
+#include <stdint.h>
+
+//Number of cells stored in each word of a packed board
+#define CELLS_PER_WORD 64
+
+int packedRowWords(int width);
+
+void packRow(const char *cells, int width, uint64_t *row);
+
+void unpackRow(const uint64_t *row, int width, char *cells);
+
+int getPackedCell(const uint64_t *board, int rowWords, int x, int y);
+
+void setPackedCell(uint64_t *board, int rowWords, int x, int y, int value);
+
+int packRegion(const uint64_t *board, int rowWords, int x, int y, int width, int height, uint64_t *buffer);
+
+void unpackRegion(uint64_t *board, int rowWords, int x, int y, int width, int height, const uint64_t *buffer);
+
+void initPackedKernel(uint32_t birth, uint32_t survival);
+
+void calculatePackedBoard(const uint64_t *board, uint64_t *nextBoard, int rowWords, int x0, int y0, int x1, int y1);
+
+#endif // PACKEDBOARD_H_INCLUDED
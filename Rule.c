@@ -0,0 +1,206 @@
+#include "Rule.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <ctype.h>
+
+//Rulestrings. Radius 1 rules are taken as B3/S23, S23/B3 or the older 23/3 (survival first), in either case, and are written back
+//out as Bx/Sy. Larger-than-Life rules are taken in the Rr,Cc,Mm,Sa..b,Bc..d,NM form Golly uses, where C has to be 0 or 2 (two
+//states), M says whether a cell counts itself, and N has to be M (the square, which is also what leaving it out means)
+
+/* Reads the digits from start up to end into a mask of neighbor counts, after an optional letter. Returns the letter (0 if there
+   wasn't one) or -1 if anything but digits 0 to 8 follow it */
+static int parseCounts(const char *start, const char *end, uint32_t *mask)
+{
+    int letter;
+
+    letter = 0;
+    *mask = 0;
+
+    if(start < end && isalpha((unsigned char)*start))
+        letter = toupper((unsigned char)*start++);
+
+    for(; start < end; start++)
+    {
+        if(*start < '0' || *start > '8')
+            return -1;
+
+        *mask |= 1 << (*start - '0');
+    }
+
+    return letter;
+}
+
+/* Reads a number, or a range of them like 3..5, from the start of text. Returns how much of text it took, 0 if it wasn't one */
+static int parseRange(const char *text, int *low, int *high)
+{
+    int taken;
+    int more;
+
+    if(sscanf(text, "%d%n", low, &taken) != 1)
+        return 0;
+
+    *high = *low;
+
+    if(strncmp(text + taken, "..", 2) == 0)
+    {
+        if(sscanf(text + taken + 2, "%d%n", high, &more) != 1)
+            return 0;
+
+        taken += 2 + more;
+    }
+
+    return taken;
+}
+
+/* Reads a Larger-than-Life rule. Radius 1 ones come out as masks like any other radius 1 rule */
+static bool parseLargerRule(const char *text, struct lifeRule *rule)
+{
+    int states;
+    int middle;
+    int cells;
+    int birthLow;
+    int birthHigh;
+    int survivalLow;
+    int survivalHigh;
+    bool seen[3] = {false, false, false};   //R, S and B have to be there
+    char field[32];
+
+    states = 0;
+    middle = 0;
+    birthLow = birthHigh = survivalLow = survivalHigh = 0;
+
+    while(*text != '\0')
+    {
+        int length = strcspn(text, ",");
+        int taken;
+        char letter;
+
+        if(length == 0 || length >= (int)sizeof(field))
+            return false;
+
+        memcpy(field, text, length);
+        field[length] = '\0';
+        letter = toupper((unsigned char)field[0]);
+        taken = 0;
+
+        switch(letter)
+        {
+        case 'R':
+            seen[0] = sscanf(field + 1, "%d%n", &rule->radius, &taken) == 1;
+            break;
+        case 'C':
+            sscanf(field + 1, "%d%n", &states, &taken);
+            break;
+        case 'M':
+            sscanf(field + 1, "%d%n", &middle, &taken);
+            break;
+        case 'S':
+            seen[1] = (taken = parseRange(field + 1, &survivalLow, &survivalHigh)) > 0;
+            break;
+        case 'B':
+            seen[2] = (taken = parseRange(field + 1, &birthLow, &birthHigh)) > 0;
+            break;
+        case 'N':
+            taken = (toupper((unsigned char)field[1]) == 'M') ? 1 : 0;
+            break;
+        }
+
+        if(taken == 0 || taken != length - 1)
+            return false;
+
+        text += length + (text[length] == ',');
+    }
+
+    if(!seen[0] || !seen[1] || !seen[2] || rule->radius < 1 || rule->radius > MAX_RULE_RADIUS || (states != 0 && states != 2) || (middle != 0 && middle != 1))
+        return false;
+
+    cells = (2 * rule->radius + 1) * (2 * rule->radius + 1);
+
+    if(birthLow < 0 || birthLow > birthHigh || birthHigh > cells || survivalLow < 0 || survivalLow > survivalHigh || survivalHigh > cells)
+        return false;
+
+    //Everything is counted over the whole square from here on. A dead cell adds nothing to it, a live one adds itself, so without M1
+    //a live cell's count is one short of the square's
+    rule->birthLow = birthLow;
+    rule->birthHigh = birthHigh;
+    rule->survivalLow = survivalLow + 1 - middle;
+    rule->survivalHigh = survivalHigh + 1 - middle;
+
+    if(rule->radius == 1)
+    {
+        for(int n = 0; n <= 8; n++)
+        {
+            if(n >= rule->birthLow && n <= rule->birthHigh)
+                rule->birth |= 1 << n;
+            if(n + 1 >= rule->survivalLow && n + 1 <= rule->survivalHigh)
+                rule->survival |= 1 << n;
+        }
+    }
+    else
+    {
+        //The name has to fit in a board file's header. The ranges are capped by the radius, so the longest one just does
+        if(snprintf(rule->name, sizeof(rule->name), "R%d,C0,M%d,S%d..%d,B%d..%d,NM", rule->radius, middle, survivalLow, survivalHigh, birthLow, birthHigh) >= (int)sizeof(rule->name))
+            return false;
+    }
+
+    return true;
+}
+
+/* Reads a rulestring, see above. Returns false if it isn't one */
+bool parseRule(const char *text, struct lifeRule *rule)
+{
+    const char *slash;
+    uint32_t masks[2];
+    int letters[2];
+    int length;
+
+    memset(rule, 0, sizeof(struct lifeRule));
+    rule->radius = 1;
+
+    if(toupper((unsigned char)text[0]) == 'R')
+    {
+        if(!parseLargerRule(text, rule))
+            return false;
+    }
+    else
+    {
+        slash = strchr(text, '/');
+
+        if(slash == NULL)
+            return false;
+
+        letters[0] = parseCounts(text, slash, &masks[0]);
+        letters[1] = parseCounts(slash + 1, text + strlen(text), &masks[1]);
+
+        if(letters[0] == 'B' && letters[1] == 'S')
+        {
+            rule->birth = masks[0];
+            rule->survival = masks[1];
+        }
+        else if((letters[0] == 'S' && letters[1] == 'B') || (letters[0] == 0 && letters[1] == 0))
+        {
+            rule->birth = masks[1];
+            rule->survival = masks[0];
+        }
+        else
+            return false;
+    }
+
+    if(rule->radius == 1)
+    {
+        length = sprintf(rule->name, "B");
+
+        for(int n = 0; n <= 8; n++)
+            if(rule->birth & (1 << n))
+                length += sprintf(rule->name + length, "%d", n);
+
+        length += sprintf(rule->name + length, "/S");
+
+        for(int n = 0; n <= 8; n++)
+            if(rule->survival & (1 << n))
+                length += sprintf(rule->name + length, "%d", n);
+    }
+
+    return true;
+}
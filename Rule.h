@@ -0,0 +1,36 @@
+#ifndef RULE_H_INCLUDED
+#define RULE_H_INCLUDED
+
+#include <stdbool.h>
+#include <stdint.h>
+
+//Largest Larger-than-Life radius taken. The ghost region grows with it, and the rule's name has to fit in a board file's header
+#define MAX_RULE_RADIUS 7
+
+//Masks of the neighbor counts a dead cell is born with and a live one survives with, bit n for n neighbors, for the rules
+//common enough that the radius 1 kernels are built specially for them (see SimdKernel.c and PackedBoard.c)
+#define LIFE_BIRTH (1 << 3)
+#define LIFE_SURVIVAL (1 << 2 | 1 << 3)
+#define HIGHLIFE_BIRTH (1 << 3 | 1 << 6)
+#define HIGHLIFE_SURVIVAL LIFE_SURVIVAL
+#define DAY_AND_NIGHT_BIRTH (1 << 3 | 1 << 6 | 1 << 7 | 1 << 8)
+#define DAY_AND_NIGHT_SURVIVAL (1 << 3 | 1 << 4 | 1 << 6 | 1 << 7 | 1 << 8)
+
+//An outer-totalistic rule: whether a cell is alive next generation only depends on whether it's alive now and how many cells
+//are alive in the square reaching radius cells out from it. Radius 1 rules are Bx/Sy rules like B3/S23, anything wider is a
+//Larger-than-Life rule, Rr,C0,Mm,Sa..b,Bc..d, where a cell is born or survives with a range of live cells around it
+struct lifeRule
+{
+    int radius;
+    uint32_t birth;         //Radius 1 only, bit n set if a dead cell with n live neighbors comes alive
+    uint32_t survival;      //And if a live one with n stays alive
+    int birthLow;           //Wider radii only, the live cells in the whole square (the cell itself included) that a dead cell
+    int birthHigh;          //comes alive with, from low to high
+    int survivalLow;        //And that a live one stays alive with
+    int survivalHigh;
+    char name[32];          //The rule written out the standard way, as it goes in a board file
+};
+
+bool parseRule(const char *text, struct lifeRule *rule);
+
+#endif // RULE_H_INCLUDED
@@ -0,0 +1,344 @@
+#include "SimdKernel.h"
+
+#include <stdlib.h>
+#include <stdbool.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define SIMD_X86
+#endif
+
+//Row sweep kernel for the one-char-per-cell board
+//For each row the three rows around it are added into column totals, then each cell's total is the sum of three
+//neighboring column totals (itself included). A dead cell with total n comes alive if bit n of the rule's birth mask is set, a live
+//one stays alive if bit n - 1 of its survival mask is. Every sweep is built once for each of the common rules with the masks as
+//constants, which folds the rule down to a compare or two per vector (for B3/S23, total == 3 or total == 4 and alive), and once more
+//for any other rule, which checks the masks as it goes
+
+//Scratch row of column totals, grown as needed. Each thread has its own
+static char *columnSums;
+static int columnSumsSize;
+#pragma omp threadprivate(columnSums, columnSumsSize)
+
+//Regions smaller than this many cells are swept by a single thread
+#define PARALLEL_CELLS 16384
+
+typedef void (*rowSweep)(const char *above, const char *middle, const char *below, char *out, char *sums, int first, int last);
+
+static rowSweep sweepRow;
+
+//The rule the sweeps built for any rule check against
+static uint32_t anyBirth;
+static uint32_t anySurvival;
+
+/* Finishes the cells from x to last one at a time, filling in column totals from sumsFrom onwards first. Used on its own and for the tail of each vector loop */
+static inline __attribute__((always_inline)) void sweepRowScalarFrom(const char *above, const char *middle, const char *below, char *out, char *sums,
+                                                                      int last, int sumsFrom, int x, uint32_t birth, uint32_t survival)
+{
+    int total;
+
+    for(int i = sumsFrom; i <= last + 1; i++)
+        sums[i] = above[i] + middle[i] + below[i];
+
+    for(; x <= last; x++)
+    {
+        total = sums[x - 1] + sums[x] + sums[x + 1];
+        out[x] = ((middle[x] ? survival << 1 : birth) >> total) & 1;
+    }
+}
+
+#ifdef SIMD_X86
+
+/* Which cells of a vector live, as 1 or 0, from their totals and whether they're alive now. Only counts that the rule does something
+   with are compared, so with constant masks this comes down to just those compares */
+__attribute__((always_inline, target("sse2")))
+static inline __m128i cellsLiveSSE2(__m128i total, __m128i cell, uint32_t birth, uint32_t survival)
+{
+    __m128i lives = _mm_setzero_si128();
+
+    #pragma GCC unroll 10
+    for(int n = 0; n <= 9; n++)
+    {
+        bool born = (birth >> n) & 1;
+        bool stays = n > 0 && ((survival >> (n - 1)) & 1);
+        __m128i match;
+
+        if(!born && !stays)
+            continue;
+
+        match = _mm_cmpeq_epi8(total, _mm_set1_epi8(n));
+
+        //Cells are 0 or 1, so only the low bit of each byte is right until the end
+        if(born && stays)
+            lives = _mm_or_si128(lives, match);
+        else if(born)
+            lives = _mm_or_si128(lives, _mm_andnot_si128(cell, match));
+        else
+            lives = _mm_or_si128(lives, _mm_and_si128(match, cell));
+    }
+
+    return _mm_and_si128(lives, _mm_set1_epi8(1));
+}
+
+__attribute__((always_inline, target("sse2")))
+static inline void sweepRowSSE2(const char *above, const char *middle, const char *below, char *out, char *sums, int first, int last, uint32_t birth, uint32_t survival)
+{
+    int i;
+    int x;
+
+    for(i = first - 1; i + 16 <= last + 2; i += 16)
+    {
+        __m128i column = _mm_add_epi8(_mm_loadu_si128((const __m128i *)(above + i)), _mm_loadu_si128((const __m128i *)(middle + i)));
+        _mm_storeu_si128((__m128i *)(sums + i), _mm_add_epi8(column, _mm_loadu_si128((const __m128i *)(below + i))));
+    }
+
+    for(; i <= last + 1; i++)
+        sums[i] = above[i] + middle[i] + below[i];
+
+    for(x = first; x + 16 <= last + 1; x += 16)
+    {
+        __m128i total = _mm_add_epi8(_mm_loadu_si128((const __m128i *)(sums + x - 1)), _mm_loadu_si128((const __m128i *)(sums + x)));
+        __m128i cell = _mm_loadu_si128((const __m128i *)(middle + x));
+        total = _mm_add_epi8(total, _mm_loadu_si128((const __m128i *)(sums + x + 1)));
+
+        _mm_storeu_si128((__m128i *)(out + x), cellsLiveSSE2(total, cell, birth, survival));
+    }
+
+    sweepRowScalarFrom(above, middle, below, out, sums, last, last + 2, x, birth, survival);
+}
+
+__attribute__((always_inline, target("avx2")))
+static inline __m256i cellsLiveAVX2(__m256i total, __m256i cell, uint32_t birth, uint32_t survival)
+{
+    __m256i lives = _mm256_setzero_si256();
+
+    #pragma GCC unroll 10
+    for(int n = 0; n <= 9; n++)
+    {
+        bool born = (birth >> n) & 1;
+        bool stays = n > 0 && ((survival >> (n - 1)) & 1);
+        __m256i match;
+
+        if(!born && !stays)
+            continue;
+
+        match = _mm256_cmpeq_epi8(total, _mm256_set1_epi8(n));
+
+        if(born && stays)
+            lives = _mm256_or_si256(lives, match);
+        else if(born)
+            lives = _mm256_or_si256(lives, _mm256_andnot_si256(cell, match));
+        else
+            lives = _mm256_or_si256(lives, _mm256_and_si256(match, cell));
+    }
+
+    return _mm256_and_si256(lives, _mm256_set1_epi8(1));
+}
+
+__attribute__((always_inline, target("avx2")))
+static inline void sweepRowAVX2(const char *above, const char *middle, const char *below, char *out, char *sums, int first, int last, uint32_t birth, uint32_t survival)
+{
+    int i;
+    int x;
+
+    for(i = first - 1; i + 32 <= last + 2; i += 32)
+    {
+        __m256i column = _mm256_add_epi8(_mm256_loadu_si256((const __m256i *)(above + i)), _mm256_loadu_si256((const __m256i *)(middle + i)));
+        _mm256_storeu_si256((__m256i *)(sums + i), _mm256_add_epi8(column, _mm256_loadu_si256((const __m256i *)(below + i))));
+    }
+
+    for(; i <= last + 1; i++)
+        sums[i] = above[i] + middle[i] + below[i];
+
+    for(x = first; x + 32 <= last + 1; x += 32)
+    {
+        __m256i total = _mm256_add_epi8(_mm256_loadu_si256((const __m256i *)(sums + x - 1)), _mm256_loadu_si256((const __m256i *)(sums + x)));
+        __m256i cell = _mm256_loadu_si256((const __m256i *)(middle + x));
+        total = _mm256_add_epi8(total, _mm256_loadu_si256((const __m256i *)(sums + x + 1)));
+
+        _mm256_storeu_si256((__m256i *)(out + x), cellsLiveAVX2(total, cell, birth, survival));
+    }
+
+    sweepRowScalarFrom(above, middle, below, out, sums, last, last + 2, x, birth, survival);
+}
+
+/* AVX-512 compares straight into mask registers, so the rule is worked out on those */
+__attribute__((always_inline, target("avx512f,avx512bw")))
+static inline __mmask64 cellsLiveAVX512(__m512i total, __mmask64 alive, uint32_t birth, uint32_t survival)
+{
+    __mmask64 lives = 0;
+
+    #pragma GCC unroll 10
+    for(int n = 0; n <= 9; n++)
+    {
+        bool born = (birth >> n) & 1;
+        bool stays = n > 0 && ((survival >> (n - 1)) & 1);
+        __mmask64 match;
+
+        if(!born && !stays)
+            continue;
+
+        match = _mm512_cmpeq_epi8_mask(total, _mm512_set1_epi8(n));
+
+        if(born && stays)
+            lives |= match;
+        else if(born)
+            lives |= match & ~alive;
+        else
+            lives |= match & alive;
+    }
+
+    return lives;
+}
+
+__attribute__((always_inline, target("avx512f,avx512bw")))
+static inline void sweepRowAVX512(const char *above, const char *middle, const char *below, char *out, char *sums, int first, int last, uint32_t birth, uint32_t survival)
+{
+    const __m512i one = _mm512_set1_epi8(1);
+    int i;
+    int x;
+
+    for(i = first - 1; i + 64 <= last + 2; i += 64)
+    {
+        __m512i column = _mm512_add_epi8(_mm512_loadu_si512(above + i), _mm512_loadu_si512(middle + i));
+        _mm512_storeu_si512(sums + i, _mm512_add_epi8(column, _mm512_loadu_si512(below + i)));
+    }
+
+    for(; i <= last + 1; i++)
+        sums[i] = above[i] + middle[i] + below[i];
+
+    for(x = first; x + 64 <= last + 1; x += 64)
+    {
+        __m512i total = _mm512_add_epi8(_mm512_loadu_si512(sums + x - 1), _mm512_loadu_si512(sums + x));
+        __m512i cell = _mm512_loadu_si512(middle + x);
+        total = _mm512_add_epi8(total, _mm512_loadu_si512(sums + x + 1));
+
+        _mm512_storeu_si512(out + x, _mm512_maskz_mov_epi8(cellsLiveAVX512(total, _mm512_test_epi8_mask(cell, cell), birth, survival), one));
+    }
+
+    sweepRowScalarFrom(above, middle, below, out, sums, last, last + 2, x, birth, survival);
+}
+
+//The vector sweeps for one rule
+#define VECTOR_RULE_SWEEPS(name, birth, survival) \
+    __attribute__((target("sse2"))) \
+    static void sweepRowSSE2##name(const char *above, const char *middle, const char *below, char *out, char *sums, int first, int last) \
+    { \
+        sweepRowSSE2(above, middle, below, out, sums, first, last, birth, survival); \
+    } \
+    __attribute__((target("avx2"))) \
+    static void sweepRowAVX2##name(const char *above, const char *middle, const char *below, char *out, char *sums, int first, int last) \
+    { \
+        sweepRowAVX2(above, middle, below, out, sums, first, last, birth, survival); \
+    } \
+    __attribute__((target("avx512f,avx512bw"))) \
+    static void sweepRowAVX512##name(const char *above, const char *middle, const char *below, char *out, char *sums, int first, int last) \
+    { \
+        sweepRowAVX512(above, middle, below, out, sums, first, last, birth, survival); \
+    }
+
+#define RULE_SWEEP_TABLE(name) {sweepRowScalar##name, sweepRowSSE2##name, sweepRowAVX2##name, sweepRowAVX512##name}
+
+#else
+
+#define VECTOR_RULE_SWEEPS(name, birth, survival)
+#define RULE_SWEEP_TABLE(name) {sweepRowScalar##name, sweepRowScalar##name, sweepRowScalar##name, sweepRowScalar##name}
+
+#endif
+
+//Every sweep for one rule, each with the rule's masks built in
+#define RULE_SWEEPS(name, birth, survival) \
+    static void sweepRowScalar##name(const char *above, const char *middle, const char *below, char *out, char *sums, int first, int last) \
+    { \
+        sweepRowScalarFrom(above, middle, below, out, sums, last, first - 1, first, birth, survival); \
+    } \
+    VECTOR_RULE_SWEEPS(name, birth, survival)
+
+RULE_SWEEPS(Life, LIFE_BIRTH, LIFE_SURVIVAL)
+RULE_SWEEPS(HighLife, HIGHLIFE_BIRTH, HIGHLIFE_SURVIVAL)
+RULE_SWEEPS(DayAndNight, DAY_AND_NIGHT_BIRTH, DAY_AND_NIGHT_SURVIVAL)
+RULE_SWEEPS(AnyRule, anyBirth, anySurvival)
+
+//Sweeps for each rule by instruction set, the last one being for any rule
+static const struct
+{
+    uint32_t birth;
+    uint32_t survival;
+    rowSweep sweeps[4];
+} ruleSweeps[] =
+{
+    {LIFE_BIRTH, LIFE_SURVIVAL, RULE_SWEEP_TABLE(Life)},
+    {HIGHLIFE_BIRTH, HIGHLIFE_SURVIVAL, RULE_SWEEP_TABLE(HighLife)},
+    {DAY_AND_NIGHT_BIRTH, DAY_AND_NIGHT_SURVIVAL, RULE_SWEEP_TABLE(DayAndNight)},
+    {0, 0, RULE_SWEEP_TABLE(AnyRule)}
+};
+
+/* Picks the best row sweep the CPU supports, up to the requested instruction set, for a rule's masks of the neighbor counts a cell
+   is born and survives with. Returns the instruction set chosen */
+simdISA initSimdKernel(simdISA requested, uint32_t birth, uint32_t survival)
+{
+    simdISA chosen;
+    int rule;
+
+    chosen = SCALAR_ISA;
+
+#ifdef SIMD_X86
+    __builtin_cpu_init();
+
+    if(requested >= SSE2_ISA && __builtin_cpu_supports("sse2"))
+        chosen = SSE2_ISA;
+
+    if(requested >= AVX2_ISA && __builtin_cpu_supports("avx2"))
+        chosen = AVX2_ISA;
+
+    if(requested >= AVX512_ISA && __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw"))
+        chosen = AVX512_ISA;
+#endif
+
+    anyBirth = birth;
+    anySurvival = survival;
+
+    for(rule = 0; rule < (int)(sizeof(ruleSweeps) / sizeof(ruleSweeps[0])) - 1; rule++)
+        if(ruleSweeps[rule].birth == birth && ruleSweeps[rule].survival == survival)
+            break;
+
+    sweepRow = ruleSweeps[rule].sweeps[chosen];
+
+    return chosen;
+}
+
+const char * simdISAName(simdISA isa)
+{
+    switch(isa)
+    {
+    case SSE2_ISA:
+        return "sse2";
+    case AVX2_ISA:
+        return "avx2";
+    case AVX512_ISA:
+        return "avx512";
+    default:
+        return "scalar";
+    }
+}
+
+/* Updates the cells x0 to x1 of rows y0 to y1 of a board whose rows are width chars apart. Everything around them is only read */
+void calculateSimdBoard(const char *board, char *nextBoard, int width, int x0, int y0, int x1, int y1)
+{
+    if(sweepRow == NULL)
+        initSimdKernel(AVX512_ISA, LIFE_BIRTH, LIFE_SURVIVAL);
+
+    #pragma omp parallel if((long)(x1 - x0 + 1) * (y1 - y0 + 1) >= PARALLEL_CELLS)
+    {
+        if(columnSumsSize < width)
+        {
+            free(columnSums);
+            columnSums = malloc(sizeof(char) * width);
+            columnSumsSize = width;
+        }
+
+        #pragma omp for
+        for(int y = y0; y <= y1; y++)
+            sweepRow(board + (y - 1) * width, board + y * width, board + (y + 1) * width, nextBoard + y * width, columnSums, x0, x1);
+    }
+}
@@ -0,0 +1,23 @@
+#ifndef SIMDKERNEL_H_INCLUDED
+#define SIMDKERNEL_H_INCLUDED
+
+#include <stdint.h>
+
+#include "Rule.h"
+
+//Instruction sets the row sweep kernel can be built for, in order of preference
+typedef enum
+{
+    SCALAR_ISA,
+    SSE2_ISA,
+    AVX2_ISA,
+    AVX512_ISA
+} simdISA;
+
+simdISA initSimdKernel(simdISA requested, uint32_t birth, uint32_t survival);
+
+const char * simdISAName(simdISA isa);
+
+void calculateSimdBoard(const char *board, char *nextBoard, int width, int x0, int y0, int x1, int y1);
+
+#endif // SIMDKERNEL_H_INCLUDED
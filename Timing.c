@@ -0,0 +1,232 @@
+#include "Timing.h"
+
+//Per phase timing, see Timing.h. Nothing here is built without GOL_TIMING
+#ifdef GOL_TIMING
+
+#include <stdio.h>
+#include <stdlib.h>
+
+//A trace keeps at most this many events per rank, past that only the totals are kept
+#define TIMING_MAX_EVENTS (1 << 20)
+
+struct timingEvent
+{
+    int phase;
+    int generation;
+    double start;
+    double end;
+};
+
+static const char *phaseNames[TIMING_PHASES] =
+{
+    "load", "partition", "read", "print", "setup", "exchange", "compute", "wait", "computeEdge", "swap", "rebalance", "checkpoint",
+    "hashlife", "barrier", "output"
+};
+
+static const char *directionNames[8] = {"NW", "N", "NE", "W", "E", "SW", "S", "SE"};
+
+static double epoch;                    //Everyone's clock starts together, so traces from different ranks line up
+static double phaseStart[TIMING_PHASES];
+static double phaseSeconds[TIMING_PHASES];
+static long long phaseCalls[TIMING_PHASES];
+static long long messages[8];           //Edges sent in each direction
+static long long messageBytes[8];
+static long long sharedCopies[8];       //Edges copied straight out of a neighbor's board on the same node, by the direction they went
+static long long sharedBytes[8];
+static long long signals[8];            //Messages saying a board is ready to be read or done with, sent alongside shared copies
+static int currentGeneration;
+static bool tracing;
+static struct timingEvent *events;
+static int numberOfEvents;
+static int eventsSize;
+
+/* Starts the clock. Every rank has to call it at the same time */
+void timingInit(bool trace)
+{
+    tracing = trace;
+    currentGeneration = -1;
+
+    MPI_Barrier(MPI_COMM_WORLD);
+    epoch = MPI_Wtime();
+}
+
+void timingStart(timingPhase phase)
+{
+    phaseStart[phase] = MPI_Wtime();
+}
+
+void timingStop(timingPhase phase)
+{
+    double end;
+
+    end = MPI_Wtime();
+    phaseSeconds[phase] += end - phaseStart[phase];
+    phaseCalls[phase]++;
+
+    if(!tracing || numberOfEvents == TIMING_MAX_EVENTS)
+        return;
+
+    if(numberOfEvents == eventsSize)
+    {
+        eventsSize = eventsSize ? eventsSize * 2 : 4096;
+        events = realloc(events, sizeof(struct timingEvent) * eventsSize);
+    }
+
+    events[numberOfEvents].phase = phase;
+    events[numberOfEvents].generation = currentGeneration;
+    events[numberOfEvents].start = phaseStart[phase] - epoch;
+    events[numberOfEvents].end = end - epoch;
+    numberOfEvents++;
+}
+
+/* Tags the events that follow with the generation being computed */
+void timingGeneration(int generation)
+{
+    currentGeneration = generation;
+}
+
+void timingMessage(int direction, long long bytes)
+{
+    messages[direction]++;
+    messageBytes[direction] += bytes;
+}
+
+void timingSharedCopy(int direction, long long bytes)
+{
+    sharedCopies[direction]++;
+    sharedBytes[direction] += bytes;
+}
+
+void timingSignal(int direction)
+{
+    signals[direction]++;
+}
+
+/* Writes every rank's events out as a Chrome trace (chrome://tracing or Perfetto), one row per rank */
+static void writeTrace(MPI_Comm comm, const char *traceFileName)
+{
+    int rank;
+    int ranks;
+    int *counts;
+    int *displacements;
+    struct timingEvent *allEvents;
+    MPI_Datatype eventType;
+    FILE *trace;
+
+    MPI_Comm_rank(comm, &rank);
+    MPI_Comm_size(comm, &ranks);
+
+    counts = malloc(sizeof(int) * ranks);
+    displacements = malloc(sizeof(int) * ranks);
+    allEvents = NULL;
+
+    MPI_Type_contiguous(sizeof(struct timingEvent), MPI_BYTE, &eventType);
+    MPI_Type_commit(&eventType);
+
+    MPI_Gather(&numberOfEvents, 1, MPI_INT, counts, 1, MPI_INT, 0, comm);
+
+    if(rank == 0)
+    {
+        int total = 0;
+
+        for(int i = 0; i < ranks; i++)
+        {
+            displacements[i] = total;
+            total += counts[i];
+        }
+
+        allEvents = malloc(sizeof(struct timingEvent) * (total > 0 ? total : 1));
+    }
+
+    MPI_Gatherv(events, numberOfEvents, eventType, allEvents, counts, displacements, eventType, 0, comm);
+    MPI_Type_free(&eventType);
+
+    if(rank == 0)
+    {
+        trace = fopen(traceFileName, "w");
+
+        if(trace == NULL)
+            printf("Could not create %s\n", traceFileName);
+        else
+        {
+            bool first = true;
+
+            fprintf(trace, "{\"traceEvents\":[\n");
+
+            for(int i = 0; i < ranks; i++)
+            {
+                struct timingEvent *rankEvents = allEvents + displacements[i];
+
+                fprintf(trace, "%s{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":%d,\"args\":{\"name\":\"rank %d\"}}", first ? "" : ",\n", i, i);
+                first = false;
+
+                for(int e = 0; e < counts[i]; e++)
+                    fprintf(trace, ",\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":%d,\"tid\":0,\"ts\":%.3f,\"dur\":%.3f,\"args\":{\"generation\":%d}}",
+                            phaseNames[rankEvents[e].phase], i, rankEvents[e].start * 1e6, (rankEvents[e].end - rankEvents[e].start) * 1e6, rankEvents[e].generation);
+            }
+
+            fprintf(trace, "\n]}\n");
+            fclose(trace);
+
+            printf("Trace written to %s\n", traceFileName);
+        }
+    }
+
+    free(allEvents);
+    free(counts);
+    free(displacements);
+}
+
+/* Prints the shortest, average and longest time any rank spent in each phase, and the edges sent in each direction by everyone.
+   With a trace file name the events are written out too. Every rank in comm has to call it */
+void timingReport(MPI_Comm comm, const char *traceFileName)
+{
+    int rank;
+    int ranks;
+    double least[TIMING_PHASES];
+    double most[TIMING_PHASES];
+    double total[TIMING_PHASES];
+    long long calls[TIMING_PHASES];
+    long long allMessages[8];
+    long long allBytes[8];
+    long long allSharedCopies[8];
+    long long allSharedBytes[8];
+    long long allSignals[8];
+
+    MPI_Comm_rank(comm, &rank);
+    MPI_Comm_size(comm, &ranks);
+
+    MPI_Reduce(phaseSeconds, least, TIMING_PHASES, MPI_DOUBLE, MPI_MIN, 0, comm);
+    MPI_Reduce(phaseSeconds, most, TIMING_PHASES, MPI_DOUBLE, MPI_MAX, 0, comm);
+    MPI_Reduce(phaseSeconds, total, TIMING_PHASES, MPI_DOUBLE, MPI_SUM, 0, comm);
+    MPI_Reduce(phaseCalls, calls, TIMING_PHASES, MPI_LONG_LONG, MPI_MAX, 0, comm);
+    MPI_Reduce(messages, allMessages, 8, MPI_LONG_LONG, MPI_SUM, 0, comm);
+    MPI_Reduce(messageBytes, allBytes, 8, MPI_LONG_LONG, MPI_SUM, 0, comm);
+    MPI_Reduce(sharedCopies, allSharedCopies, 8, MPI_LONG_LONG, MPI_SUM, 0, comm);
+    MPI_Reduce(sharedBytes, allSharedBytes, 8, MPI_LONG_LONG, MPI_SUM, 0, comm);
+    MPI_Reduce(signals, allSignals, 8, MPI_LONG_LONG, MPI_SUM, 0, comm);
+
+    if(rank == 0)
+    {
+        printf("\n%-12s %12s %12s %12s %10s\n", "Phase", "Min s", "Average s", "Max s", "Calls");
+
+        for(int i = 0; i < TIMING_PHASES; i++)
+            if(calls[i] > 0)
+                printf("%-12s %12.6f %12.6f %12.6f %10lld\n", phaseNames[i], least[i], total[i] / ranks, most[i], calls[i]);
+
+        printf("\n%-12s %12s %12s %12s %12s %12s\n", "Direction", "Messages", "Bytes", "Shared", "Shared bytes", "Signals");
+
+        for(int i = 0; i < 8; i++)
+            printf("%-12s %12lld %12lld %12lld %12lld %12lld\n", directionNames[i], allMessages[i], allBytes[i], allSharedCopies[i], allSharedBytes[i], allSignals[i]);
+    }
+
+    if(traceFileName != NULL)
+        writeTrace(comm, traceFileName);
+
+    free(events);
+    events = NULL;
+    numberOfEvents = 0;
+    eventsSize = 0;
+}
+
+#endif
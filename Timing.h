@@ -0,0 +1,69 @@
+#ifndef TIMING_H_INCLUDED
+#define TIMING_H_INCLUDED
+
+#include <stdbool.h>
+#include <mpi.h>
+
+//Phases the run is timed in. Built with -DGOL_TIMING, each rank adds up the time it spends in each one and can record every one
+//as an event for a Chrome trace. Without it the TIMING_ macros are empty and none of this is compiled in
+typedef enum
+{
+    TIMING_LOAD,            //Opening the board file or checkpoint and reading its header
+    TIMING_PARTITION,       //Splitting the board and building the topology
+    TIMING_READ,            //Reading our partition
+    TIMING_PRINT,           //Gathering and printing the initial board
+    TIMING_SETUP,           //Building the tiles and halo exchange
+    TIMING_EXCHANGE,        //Packing edges and starting the exchange
+    TIMING_COMPUTE,         //Cells that don't need the edges being exchanged
+    TIMING_WAIT,            //Waiting for edges and landing them in the ghost region
+    TIMING_COMPUTE_EDGE,    //Cells that needed them
+    TIMING_SWAP,            //Swapping the boards
+    TIMING_REBALANCE,
+    TIMING_CHECKPOINT,
+    TIMING_HASHLIFE,
+    TIMING_BARRIER,         //Waiting for everyone after the last generation
+    TIMING_OUTPUT,          //Writing or gathering and printing the final board
+    TIMING_PHASES
+} timingPhase;
+
+#ifdef GOL_TIMING
+
+void timingInit(bool trace);
+
+void timingStart(timingPhase phase);
+
+void timingStop(timingPhase phase);
+
+void timingGeneration(int generation);
+
+void timingMessage(int direction, long long bytes);
+
+void timingSharedCopy(int direction, long long bytes);
+
+void timingSignal(int direction);
+
+void timingReport(MPI_Comm comm, const char *traceFileName);
+
+#define TIMING_INIT(trace) timingInit(trace)
+#define TIMING_START(phase) timingStart(phase)
+#define TIMING_STOP(phase) timingStop(phase)
+#define TIMING_GENERATION(generation) timingGeneration(generation)
+#define TIMING_MESSAGE(direction, bytes) timingMessage(direction, bytes)
+#define TIMING_SHARED_COPY(direction, bytes) timingSharedCopy(direction, bytes)
+#define TIMING_SIGNAL(direction) timingSignal(direction)
+#define TIMING_REPORT(comm, traceFileName) timingReport(comm, traceFileName)
+
+#else
+
+#define TIMING_INIT(trace) ((void)0)
+#define TIMING_START(phase) ((void)0)
+#define TIMING_STOP(phase) ((void)0)
+#define TIMING_GENERATION(generation) ((void)0)
+#define TIMING_MESSAGE(direction, bytes) ((void)0)
+#define TIMING_SHARED_COPY(direction, bytes) ((void)0)
+#define TIMING_SIGNAL(direction) ((void)0)
+#define TIMING_REPORT(comm, traceFileName) ((void)0)
+
+#endif
+
+#endif // TIMING_H_INCLUDED
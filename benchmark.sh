@@ -0,0 +1,138 @@
+#!/bin/bash
+#Strong and weak scaling benchmark. Runs random boards (made up by the ranks themselves with -random, so there are no files to
+#write or read) over a range of rank counts with -quiet, and writes one line per run as CSV (or JSON with -json) with the cells
+#updated per second and the parallel efficiency
+#
+#Build the program first:
+#   mpicc MPI_Partition.c GeometrySplitter.c PackedBoard.c SimdKernel.c LookupKernel.c BoardFile.c Hashlife.c Timing.c Rule.c LargerKernel.c -std=c99 -O2 -fopenmp -lm
+#
+#Usage: ./benchmark.sh [-ranks "1 2 4 8"] [-size cells] [-density fraction] [-seed number] [-generations count] [-mode strong|weak|both]
+#                      [-json] [-out file] [-compare baseline.csv [-tolerance percent]] [-- options for the program, like -engine packed]
+#
+#Strong scaling runs a size by size board on every rank count. Weak scaling gives each rank as many cells as the first rank count has
+#per rank, by adding rows. Efficiency is against the first rank count. With -compare, any run whose cells per second dropped more
+#than the tolerance (10% by default) below the same mode and rank count in an earlier CSV is reported, and the script exits with 2
+
+GOL=${GOL:-./a.out}
+MPIRUN=${MPIRUN:-"mpirun --oversubscribe"}
+
+ranks="1 2 4 8"
+size=2048
+density=0.3
+seed=1
+generations=100
+mode=both
+json=0
+out=/dev/stdout
+baseline=
+tolerance=10
+
+while [ $# -gt 0 ]
+do
+    case $1 in
+        -ranks) ranks=$2; shift 2;;
+        -size) size=$2; shift 2;;
+        -density) density=$2; shift 2;;
+        -seed) seed=$2; shift 2;;
+        -generations) generations=$2; shift 2;;
+        -mode) mode=$2; shift 2;;
+        -json) json=1; shift;;
+        -out) out=$2; shift 2;;
+        -compare) baseline=$2; shift 2;;
+        -tolerance) tolerance=$2; shift 2;;
+        --) shift; break;;
+        *) echo "Unknown option $1, see the top of $0"; exit 1;;
+    esac
+done
+
+if [ ! -x "$GOL" ]
+then
+    echo "Couldn't find $GOL, build it first (see the top of $0)"
+    exit 1
+fi
+
+firstRanks=${ranks%% *}
+results=()
+
+#Runs one board on some number of ranks and prints the program's line of timings
+runBoard()
+{
+    local n=$1
+    local rows=$2
+    local line
+
+    shift 2
+
+    line=$($MPIRUN -n "$n" "$GOL" -quiet "$@" -random "$size" "$rows" "$density" "$seed" "$generations" | grep -E '^[0-9]+,[0-9]+,[a-z]+,' | tail -n 1)
+
+    if [ -z "$line" ]
+    then
+        echo "The run on $n ranks of a $size by $rows board failed" >&2
+        exit 1
+    fi
+
+    echo "$line"
+}
+
+for m in strong weak
+do
+    [ "$mode" = both ] || [ "$mode" = $m ] || continue
+
+    baseSeconds=
+
+    for n in $ranks
+    do
+        if [ $m = strong ]
+        then
+            rows=$size
+        else
+            rows=$(( size * n / firstRanks ))
+        fi
+
+        line=$(runBoard "$n" "$rows" "$@") || exit 1
+        seconds=$(echo "$line" | cut -d, -f7)
+
+        if [ -z "$baseSeconds" ]
+        then
+            baseSeconds=$seconds
+        fi
+
+        #Strong scaling should divide the time by the ranks, weak scaling should keep it the same
+        if [ $m = strong ]
+        then
+            efficiency=$(awk -v b="$baseSeconds" -v s="$seconds" -v f="$firstRanks" -v n="$n" 'BEGIN { printf "%.3f", (s > 0 ? b * f / (s * n) : 0) }')
+        else
+            efficiency=$(awk -v b="$baseSeconds" -v s="$seconds" 'BEGIN { printf "%.3f", (s > 0 ? b / s : 0) }')
+        fi
+
+        results+=("$m,$line,$efficiency")
+    done
+done
+
+fields="mode,ranks,threads,engine,columns,rows,generations,seconds,secondsPerGeneration,cellsPerSecond,efficiency"
+
+if [ $json = 1 ]
+then
+    printf '%s\n' "${results[@]}" | awk -F, -v fields="$fields" '
+        BEGIN { split(fields, name, ","); print "[" }
+        {
+            line = "  {"
+            for(i = 1; i <= NF; i++)
+                line = line (i > 1 ? ", " : "") "\"" name[i] "\": " ((i == 1 || i == 4) ? "\"" $i "\"" : $i)
+            lines[NR] = line "}"
+        }
+        END { for(i = 1; i <= NR; i++) print lines[i] (i < NR ? "," : ""); print "]" }' > "$out"
+else
+    { echo "$fields"; printf '%s\n' "${results[@]}"; } > "$out"
+fi
+
+if [ -n "$baseline" ]
+then
+    printf '%s\n' "${results[@]}" | awk -F, -v tolerance="$tolerance" '
+        NR == FNR { if(FNR > 1) before[$1 "," $2] = $10; next }
+        ($1 "," $2) in before && $10 < before[$1 "," $2] * (1 - tolerance / 100) {
+            printf "Regression: %s scaling on %s ranks ran %.0f cells/s, down from %.0f\n", $1, $2, $10, before[$1 "," $2] > "/dev/stderr"
+            slower = 1
+        }
+        END { exit slower ? 2 : 0 }' "$baseline" - || exit 2
+fi